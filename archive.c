@@ -0,0 +1,396 @@
+/**
+* @file archive.c
+* @author Sadia Ahmed (sahmed23)
+* This file stores many saved games in one file
+* with an index of where every game starts, read through a single mapping
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "archive.h"
+#include "io.h"
+#include "game.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * Reads a little-endian number of bytes bytes from p.
+ * @param p The first byte.
+ * @param bytes The width of the number, 4 or 8.
+ * @return uint64_t The number.
+ */
+static uint64_t archive_read( const unsigned char* p, int bytes )
+{
+    // Storing the number read so far
+    uint64_t value = INITIALIZE;
+
+    for ( int i = bytes - 1; i >= INITIALIZE; i-- ) {
+        value = value << 8 | p[i];
+    }
+    return value;
+}
+
+/**
+ * Writes value to p as a little-endian number of bytes bytes.
+ * @param p The first byte.
+ * @param value The number.
+ * @param bytes The width of the number, 4 or 8.
+ */
+static void archive_put( unsigned char* p, uint64_t value, int bytes )
+{
+    for ( int i = INITIALIZE; i < bytes; i++ ) {
+        p[i] = ( value >> ( 8 * i ) ) & 0xFF;
+    }
+}
+
+/**
+ * Fills in the offsets, count and end of a from its mapped contents: from the index if the trailer is there and consistent,
+ * otherwise by walking the length prefixes of the records up to the first one that is cut short or empty.
+ * @param a A pointer to the archive, with data and length set.
+ * @return unsigned char SUCCESS, FILE_INPUT_ERR if the header is wrong, or MEMORY_ERR if memory runs out.
+ */
+static unsigned char archive_index( archive* a )
+{
+    const unsigned char* data = ( const unsigned char* ) a->data;
+
+    if ( a->length < ARCHIVE_HEADER_SIZE || memcmp( data, ARCHIVE_MAGIC, GMK_MAGIC_LENGTH ) != 0 || data[2] != ARCHIVE_VERSION ) {
+        return FILE_INPUT_ERR;
+    }
+
+    if ( a->length >= ARCHIVE_HEADER_SIZE + ARCHIVE_TRAILER_SIZE ) {
+
+        // Storing the trailer at the end of the file
+        const unsigned char* trailer = data + a->length - ARCHIVE_TRAILER_SIZE;
+        uint64_t index = archive_read( trailer, 8 );
+        uint64_t count = archive_read( trailer + 8, 4 );
+
+        // Storing the end of the index, the trailer being at the end of the file
+        uint64_t bound = a->length - ARCHIVE_TRAILER_SIZE;
+
+        // The index is compared with what is left before the trailer, so a corrupt offset or count can't wrap around
+        if ( memcmp( trailer + 12, ARCHIVE_INDEX_MAGIC, GMK_MAGIC_LENGTH ) == 0 && trailer[14] == ARCHIVE_VERSION &&
+             index >= ARCHIVE_HEADER_SIZE && index <= bound && count <= ( bound - index ) / ARCHIVE_INDEX_ENTRY_SIZE &&
+             index + count * ARCHIVE_INDEX_ENTRY_SIZE == bound ) {
+
+            a->offsets = ( uint64_t* ) malloc( ( count + 1 ) * sizeof( uint64_t ) );
+
+            if ( !a->offsets ) {
+                return MEMORY_ERR;
+            }
+
+            for ( size_t i = INITIALIZE; i < count; i++ ) {
+                a->offsets[i] = archive_read( data + index + i * ARCHIVE_INDEX_ENTRY_SIZE, 8 );
+            }
+            a->count = count;
+            a->end = index;
+
+            return SUCCESS;
+        }
+    }
+
+    // No index, walk the records from the header on
+    size_t capacity = GAME_CAPACITY;
+    uint64_t offset = ARCHIVE_HEADER_SIZE;
+
+    a->offsets = ( uint64_t* ) malloc( capacity * sizeof( uint64_t ) );
+
+    if ( !a->offsets ) {
+        return MEMORY_ERR;
+    }
+
+    // No game is empty, a record of length 0 was never finished
+    while ( offset + ARCHIVE_RECORD_SIZE <= a->length && archive_read( data + offset, ARCHIVE_RECORD_SIZE ) > INITIALIZE &&
+            offset + ARCHIVE_RECORD_SIZE + archive_read( data + offset, ARCHIVE_RECORD_SIZE ) <= a->length ) {
+
+        if ( a->count >= capacity ) {
+
+            // Storing the grown array, the old one stays valid if realloc fails
+            uint64_t* offsets = ( uint64_t* ) realloc( a->offsets, capacity * CAPACITY_INCREASE * sizeof( uint64_t ) );
+
+            if ( !offsets ) {
+                return MEMORY_ERR;
+            }
+            a->offsets = offsets;
+            capacity *= CAPACITY_INCREASE;
+        }
+
+        a->offsets[a->count++] = offset;
+        offset += ARCHIVE_RECORD_SIZE + archive_read( data + offset, ARCHIVE_RECORD_SIZE );
+    }
+    a->end = offset;
+
+    return SUCCESS;
+}
+
+unsigned char archive_open( const char* path, archive** a )
+{
+    *a = NULL;
+
+    // Opening the file
+    int fd = open( path, O_RDONLY );
+
+    if ( fd < 0 ) {
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the file status for its length
+    struct stat st;
+
+    if ( fstat( fd, &st ) != 0 || st.st_size < ARCHIVE_HEADER_SIZE ) {
+        close( fd );
+        return FILE_INPUT_ERR;
+    }
+
+    // Create the dynamically allocated archive
+    archive* Archive = ( archive* ) calloc( 1, sizeof( archive ) );
+
+    if ( !Archive ) {
+        close( fd );
+        return MEMORY_ERR;
+    }
+
+    // Mapping the whole file, the descriptor isn't needed afterwards
+    Archive->length = st.st_size;
+    Archive->data = mmap( NULL, Archive->length, PROT_READ, MAP_PRIVATE, fd, INITIALIZE );
+    close( fd );
+
+    if ( Archive->data == MAP_FAILED ) {
+        free( Archive );
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the status of reading the index
+    unsigned char status = archive_index( Archive );
+
+    if ( status != SUCCESS ) {
+        archive_close( Archive );
+        return status;
+    }
+
+    *a = Archive;
+
+    return SUCCESS;
+}
+
+unsigned char archive_close( archive* a )
+{
+    if ( !a ) {
+        return NULL_POINTER_ERR;
+    }
+
+    munmap( a->data, a->length );
+    free( a->offsets );
+    free( a );
+
+    return SUCCESS;
+}
+
+unsigned char archive_game( archive* a, size_t i, game** g )
+{
+    *g = NULL;
+
+    if ( i >= a->count ) {
+        return ARGUMENT_ERR;
+    }
+
+    // Storing the record of game i, which has to lie between the header and the index
+    const unsigned char* data = ( const unsigned char* ) a->data;
+    uint64_t offset = a->offsets[i];
+
+    if ( offset < ARCHIVE_HEADER_SIZE || offset > a->end - ARCHIVE_RECORD_SIZE ||
+         archive_read( data + offset, ARCHIVE_RECORD_SIZE ) > a->end - ARCHIVE_RECORD_SIZE - offset ) {
+        return FILE_INPUT_ERR;
+    }
+
+    return game_import_memory( data + offset + ARCHIVE_RECORD_SIZE, archive_read( data + offset, ARCHIVE_RECORD_SIZE ), g );
+}
+
+unsigned char archive_next( archive* a, game** g )
+{
+    *g = NULL;
+
+    if ( a->next >= a->count ) {
+        return SUCCESS;
+    }
+
+    return archive_game( a, a->next++, g );
+}
+
+unsigned char archive_writer_open( const char* path, unsigned char format, archive_writer** w )
+{
+    *w = NULL;
+
+    // Create the dynamically allocated writer
+    archive_writer* Writer = ( archive_writer* ) calloc( 1, sizeof( archive_writer ) );
+
+    if ( !Writer ) {
+        return FILE_OUTPUT_ERR;
+    }
+
+    Writer->format = format;
+
+    // Storing the file status to tell a new archive from an existing one
+    struct stat st;
+
+    if ( stat( path, &st ) == 0 && st.st_size > 0 ) {
+
+        archive* existing = NULL;
+
+        if ( archive_open( path, &existing ) != SUCCESS ) {
+            free( Writer );
+            return FILE_OUTPUT_ERR;
+        }
+
+        // Taking over the offsets of the games already there
+        Writer->offsets = existing->offsets;
+        Writer->count = existing->count;
+        Writer->capacity = existing->count;
+        Writer->end = existing->end;
+        existing->offsets = NULL;
+        archive_close( existing );
+
+        // The index goes until the writer closes, a crash leaves an archive that is read by walking the records
+        Writer->fp = fopen( path, "r+b" );
+
+        if ( !Writer->fp || ftruncate( fileno( Writer->fp ), Writer->end ) != 0 || fseek( Writer->fp, Writer->end, SEEK_SET ) != 0 ) {
+            if ( Writer->fp ) {
+                fclose( Writer->fp );
+            }
+            free( Writer->offsets );
+            free( Writer );
+            return FILE_OUTPUT_ERR;
+        }
+    } else {
+
+        // Storing the header of a new archive
+        unsigned char header[ARCHIVE_HEADER_SIZE] = { INITIALIZE };
+
+        memcpy( header, ARCHIVE_MAGIC, GMK_MAGIC_LENGTH );
+        header[2] = ARCHIVE_VERSION;
+
+        Writer->fp = fopen( path, "w+b" );
+
+        if ( !Writer->fp || fwrite( header, ARCHIVE_HEADER_SIZE, 1, Writer->fp ) != 1 || fflush( Writer->fp ) != 0 ) {
+            if ( Writer->fp ) {
+                fclose( Writer->fp );
+            }
+            free( Writer );
+            return FILE_OUTPUT_ERR;
+        }
+        Writer->end = ARCHIVE_HEADER_SIZE;
+    }
+
+    *w = Writer;
+
+    return SUCCESS;
+}
+
+unsigned char archive_writer_append( archive_writer* w, game* g )
+{
+    if ( w->count >= w->capacity ) {
+
+        // Storing the new capacity of the offsets
+        size_t capacity = w->capacity ? w->capacity * CAPACITY_INCREASE : GAME_CAPACITY;
+
+        // Storing the grown array, the old one stays valid if realloc fails
+        uint64_t* offsets = ( uint64_t* ) realloc( w->offsets, capacity * sizeof( uint64_t ) );
+
+        if ( !offsets ) {
+            return FILE_OUTPUT_ERR;
+        }
+        w->offsets = offsets;
+        w->capacity = capacity;
+    }
+
+    // Storing the record built in memory, length prefix first, so it reaches the file in a single write
+    char* record = NULL;
+    size_t length = INITIALIZE;
+    FILE* memory = open_memstream( &record, &length );
+
+    // Storing the length prefix, filled in once the game is written after it
+    unsigned char prefix[ARCHIVE_RECORD_SIZE] = { INITIALIZE };
+
+    // Storing whether the record was built
+    bool built = memory && fwrite( prefix, ARCHIVE_RECORD_SIZE, 1, memory ) == 1 && game_write( g, memory, w->format ) == SUCCESS;
+
+    if ( memory && fclose( memory ) != 0 ) {
+        built = false;
+    }
+
+    if ( !built ) {
+        free( record );
+        return FILE_OUTPUT_ERR;
+    }
+
+    archive_put( ( unsigned char* ) record, length - ARCHIVE_RECORD_SIZE, ARCHIVE_RECORD_SIZE );
+
+    // Storing whether the record was written
+    bool written = fwrite( record, length, 1, w->fp ) == 1 && fflush( w->fp ) == 0;
+
+    free( record );
+
+    if ( !written ) {
+
+        // Dropping whatever part of the record made it out, so the next one starts in the right place
+        fflush( w->fp );
+        if ( ftruncate( fileno( w->fp ), w->end ) != 0 ) {
+            clearerr( w->fp );
+        }
+        fseek( w->fp, w->end, SEEK_SET );
+        return FILE_OUTPUT_ERR;
+    }
+
+    w->offsets[w->count++] = w->end;
+    w->end += length;
+
+    return SUCCESS;
+}
+
+unsigned char archive_writer_close( archive_writer* w )
+{
+    if ( !w ) {
+        return NULL_POINTER_ERR;
+    }
+
+    // Storing the index and trailer, written in one go
+    size_t length = w->count * ARCHIVE_INDEX_ENTRY_SIZE + ARCHIVE_TRAILER_SIZE;
+    unsigned char* buffer = ( unsigned char* ) calloc( length, 1 );
+
+    // Storing whether everything was written
+    bool written = buffer != NULL;
+
+    if ( written ) {
+
+        // Storing the trailer after the index
+        unsigned char* trailer = buffer + w->count * ARCHIVE_INDEX_ENTRY_SIZE;
+
+        for ( size_t i = INITIALIZE; i < w->count; i++ ) {
+            archive_put( buffer + i * ARCHIVE_INDEX_ENTRY_SIZE, w->offsets[i], ARCHIVE_INDEX_ENTRY_SIZE );
+        }
+
+        archive_put( trailer, w->end, 8 );
+        archive_put( trailer + 8, w->count, 4 );
+        memcpy( trailer + 12, ARCHIVE_INDEX_MAGIC, GMK_MAGIC_LENGTH );
+        trailer[14] = ARCHIVE_VERSION;
+
+        written = fwrite( buffer, length, 1, w->fp ) == 1;
+    }
+
+    free( buffer );
+    free( w->offsets );
+
+    if ( fclose( w->fp ) != 0 ) {
+        written = false;
+    }
+    free( w );
+
+    return written ? SUCCESS : FILE_OUTPUT_ERR;
+}
@@ -0,0 +1,117 @@
+#ifndef _ARCHIVE_H_
+#define _ARCHIVE_H_
+#include "game.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define ARCHIVE_MAGIC "GR"
+#define ARCHIVE_INDEX_MAGIC "GI"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_HEADER_SIZE 4
+#define ARCHIVE_RECORD_SIZE 4
+#define ARCHIVE_INDEX_ENTRY_SIZE 8
+#define ARCHIVE_TRAILER_SIZE 16
+
+/*
+ * .gmka archive (version 1) layout, all multi-byte fields little-endian:
+ *   0  "GR"           magic
+ *   2  version        ARCHIVE_VERSION
+ *   3  reserved       0
+ *   4  records        one per game: a 32-bit length followed by that many bytes of a text or binary .gmk file
+ *      index          64-bit offset of every record, in order
+ *      trailer        64-bit offset of the index, 32-bit number of games, "GI", ARCHIVE_VERSION, 0
+ * The index and trailer are written when the writer is closed. An archive without them, left by a writer that
+ * didn't close, is still read by walking the length prefixes; a record cut short at the end is ignored.
+ */
+
+/**
+ * An archive open for reading. The file stays memory-mapped while the archive is open,
+ * offsets holds the offset of every record, end the offset just after the last one,
+ * and next is the game archive_next() returns next.
+ */
+typedef struct {
+    void* data;
+    size_t length;
+    uint64_t* offsets;
+    size_t count;
+    uint64_t end;
+    size_t next;
+} archive;
+
+/**
+ * An archive open for appending games. offsets holds the offset of every record written so far,
+ * end is the offset the next record goes to, and format is the .gmk format records are written in.
+ */
+typedef struct {
+    FILE* fp;
+    unsigned char format;
+    uint64_t* offsets;
+    size_t count;
+    size_t capacity;
+    uint64_t end;
+} archive_writer;
+
+/**
+ * Opens the archive at path for reading and stores it in a. The file is mapped once and the index is read,
+ * or rebuilt from the length prefixes if the archive wasn't closed; no game is imported yet.
+ * @param path The path to the archive.
+ * @param a A pointer to store the open archive, set to NULL on error.
+ * @return unsigned char SUCCESS, or FILE_INPUT_ERR if the file can't be read or isn't an archive (MEMORY_ERR if memory runs out).
+ */
+unsigned char archive_open(const char* path, archive** a);
+
+/**
+ * Unmaps and frees an archive open for reading.
+ * If a is NULL, return NULL_POINTER_ERR as defined in error-codes.h, otherwise return SUCCESS.
+ * @param a A pointer to the archive.
+ * @return unsigned char SUCCESS, or NULL_POINTER_ERR.
+ */
+unsigned char archive_close(archive* a);
+
+/**
+ * Imports game i of archive a, numbered from 0, with game_import_memory() and stores it in g.
+ * @param a A pointer to the archive.
+ * @param i The number of the game.
+ * @param g A pointer to store the reconstructed game struct, set to NULL on error.
+ * @return unsigned char SUCCESS, ARGUMENT_ERR if there is no game i, or the error of game_import_memory().
+ */
+unsigned char archive_game(archive* a, size_t i, game** g);
+
+/**
+ * Imports the next game of archive a, starting from game 0, and stores it in g.
+ * Once every game has been returned, *g is set to NULL and SUCCESS is returned.
+ * A game that can't be imported returns its error but is still skipped, so iteration can go on.
+ * @param a A pointer to the archive.
+ * @param g A pointer to store the reconstructed game struct, or NULL at the end.
+ * @return unsigned char SUCCESS, or the error of game_import_memory().
+ */
+unsigned char archive_next(archive* a, game** g);
+
+/**
+ * Opens the archive at path for appending games in format (GMK_FORMAT_TEXT or GMK_FORMAT_BINARY) and stores the writer in w.
+ * A missing file is created. An existing archive keeps its games, its index is dropped from the file
+ * until archive_writer_close() writes the new one. A file that exists but isn't an archive is left alone.
+ * @param path The path to the archive.
+ * @param format The format of the records to write.
+ * @param w A pointer to store the writer, set to NULL on error.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if the file can't be opened, read or written.
+ */
+unsigned char archive_writer_open(const char* path, unsigned char format, archive_writer** w);
+
+/**
+ * Appends game g to the archive as one record and flushes it to the file, so readers see every finished game
+ * even if the writer never closes.
+ * @param w A pointer to the writer.
+ * @param g A pointer to the game struct to append.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if the record can't be written.
+ */
+unsigned char archive_writer_append(archive_writer* w, game* g);
+
+/**
+ * Writes the index and trailer after the last record, closes the file and frees the writer.
+ * If w is NULL, return NULL_POINTER_ERR.
+ * @param w A pointer to the writer.
+ * @return unsigned char SUCCESS, NULL_POINTER_ERR, or FILE_OUTPUT_ERR if the index can't be written.
+ */
+unsigned char archive_writer_close(archive_writer* w);
+#endif
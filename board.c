@@ -5,6 +5,8 @@
 * other related functions with player move coordinates
 */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "io.h"
 #include "board.h"
 #include "game.h"
@@ -14,35 +16,118 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <pthread.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+// Zobrist numbers per stone colour and intersection, plus one per board size
+static uint64_t board_zobrist[BOARD_COLORS][BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+static uint64_t board_zobrist_size[BOARD_MAX_SIZE + 1];
+
+// The class of every character for the coordinate scanner, with the value of letters and digits in the low bits
+static const unsigned char board_chars[256] = {
+    [ '\0' ] = BOARD_CHAR_END, [ ' ' ] = BOARD_CHAR_END, [ '\t' ] = BOARD_CHAR_END, [ '\n' ] = BOARD_CHAR_END, [ '\r' ] = BOARD_CHAR_END,
+    [ '0' ] = BOARD_CHAR_DIGIT | 0, [ '1' ] = BOARD_CHAR_DIGIT | 1, [ '2' ] = BOARD_CHAR_DIGIT | 2, [ '3' ] = BOARD_CHAR_DIGIT | 3,
+    [ '4' ] = BOARD_CHAR_DIGIT | 4, [ '5' ] = BOARD_CHAR_DIGIT | 5, [ '6' ] = BOARD_CHAR_DIGIT | 6, [ '7' ] = BOARD_CHAR_DIGIT | 7,
+    [ '8' ] = BOARD_CHAR_DIGIT | 8, [ '9' ] = BOARD_CHAR_DIGIT | 9,
+    [ 'A' ] = BOARD_CHAR_LETTER | 0, [ 'B' ] = BOARD_CHAR_LETTER | 1, [ 'C' ] = BOARD_CHAR_LETTER | 2, [ 'D' ] = BOARD_CHAR_LETTER | 3,
+    [ 'E' ] = BOARD_CHAR_LETTER | 4, [ 'F' ] = BOARD_CHAR_LETTER | 5, [ 'G' ] = BOARD_CHAR_LETTER | 6, [ 'H' ] = BOARD_CHAR_LETTER | 7,
+    [ 'I' ] = BOARD_CHAR_LETTER | 8, [ 'J' ] = BOARD_CHAR_LETTER | 9, [ 'K' ] = BOARD_CHAR_LETTER | 10, [ 'L' ] = BOARD_CHAR_LETTER | 11,
+    [ 'M' ] = BOARD_CHAR_LETTER | 12, [ 'N' ] = BOARD_CHAR_LETTER | 13, [ 'O' ] = BOARD_CHAR_LETTER | 14, [ 'P' ] = BOARD_CHAR_LETTER | 15,
+    [ 'Q' ] = BOARD_CHAR_LETTER | 16, [ 'R' ] = BOARD_CHAR_LETTER | 17, [ 'S' ] = BOARD_CHAR_LETTER | 18,
+};
+
+// The row numbers as they are written, indexed by y
+static const char board_numbers[BOARD_MAX_SIZE][3] = {
+    "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13", "14", "15", "16", "17", "18", "19",
+};
+
+// Makes sure the Zobrist numbers are generated once, whichever thread creates the first board
+static pthread_once_t board_zobrist_once = PTHREAD_ONCE_INIT;
+
+/**
+ * This function returns the next number of a splitmix64 sequence, advancing state.
+ * @param state A pointer to the generator state.
+ * @return uint64_t The next pseudo-random number.
+ */
+static uint64_t board_splitmix( uint64_t* state )
+{
+    // Storing the mixed value
+    uint64_t z = ( *state += BOARD_ZOBRIST_SEED );
+
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+    return z ^ ( z >> 31 );
+}
+
+/**
+ * This function fills the Zobrist tables from the fixed seed.
+ */
+static void board_zobrist_init( void )
+{
+    // Storing the generator state
+    uint64_t state = INITIALIZE;
+
+    for ( int color = INITIALIZE; color < BOARD_COLORS; color++ ) {
+        for ( int i = INITIALIZE; i < BOARD_MAX_SIZE * BOARD_MAX_SIZE; i++ ) {
+            board_zobrist[color][i] = board_splitmix( &state );
+        }
+    }
+
+    for ( int size = INITIALIZE; size <= BOARD_MAX_SIZE; size++ ) {
+        board_zobrist_size[size] = board_splitmix( &state );
+    }
+}
 
 board* board_create( unsigned char size ) 
 {
 
     // Check if size is valid
-    if ( size <= INITIALIZE ) {
-        exit( BOARD_SIZE_ERR );
+    if ( size <= INITIALIZE || size > BOARD_MAX_SIZE ) {
+        return NULL;
     }
     
     // Create the dynamically allocated board
     board *Board = ( board * ) malloc( sizeof( board ) );
 
+    if ( !Board ) {
+        return NULL;
+    }
 
     // Assign values to struct fields
     Board->size = size;
     Board->grid = ( unsigned char* ) malloc( size * size * sizeof ( unsigned char ) );
 
+    if ( !Board->grid ) {
+        free( Board );
+        return NULL;
+    }
+
     // Initialize to INITIALIZE
     memset( Board->grid, INITIALIZE, size * size * sizeof( unsigned char ) );
 
+    pthread_once( &board_zobrist_once, board_zobrist_init );
+
+    // The bitboards start out empty as well
+    memset( Board->rows, INITIALIZE, sizeof( Board->rows ) );
+    memset( Board->cols, INITIALIZE, sizeof( Board->cols ) );
+    memset( Board->diagonals, INITIALIZE, sizeof( Board->diagonals ) );
+    memset( Board->anti_diagonals, INITIALIZE, sizeof( Board->anti_diagonals ) );
+
+    // An empty board is keyed by its size alone
+    Board->stones_count = INITIALIZE;
+    Board->key = board_zobrist_size[size];
+
     return Board;
 }
 
-void board_delete( board* b ) 
+unsigned char board_delete( board* b ) 
 {
     
     // Check if b is null
     if ( !b ) {
-        exit (NULL_POINTER_ERR);
+        return NULL_POINTER_ERR;
     }
 
     if ( b->grid ) {
@@ -50,99 +135,239 @@ void board_delete( board* b )
         b->grid = NULL;
     }
     free( b );
-    b = NULL;
+
+    return SUCCESS;
 }
 
 
 
-void board_print( board* b, bool in_place ) 
-{   
+// The escape sequence of clear(), the glyph of each intersection state and their lengths
+#define CLEAR_SEQUENCE "\033[H\033[J"
+static const char* const board_glyphs[] = { "+", "\u25CF", "\u25CB" };
+static const size_t board_glyph_lengths[] = { sizeof( "+" ) - 1, sizeof( "\u25CF" ) - 1, sizeof( "\u25CB" ) - 1 };
+
+size_t board_render( board* b, bool in_place, char* frame )
+{
     // Casting the board grid
     unsigned char ( *grid )[b->size] = ( unsigned char ( * )[b->size] ) b->grid;
 
+    // Storing the end of the frame so far
+    char* p = frame;
+
     if ( in_place ) {
-        clear( );
+        memcpy( p, CLEAR_SEQUENCE, sizeof( CLEAR_SEQUENCE ) - 1 );
+        p += sizeof( CLEAR_SEQUENCE ) - 1;
     }
 
-    // Print the board with rows and columns
+    // Render the board with rows and columns
     for ( int i = b->size - 1; i >= INITIALIZE; i-- ) {
-        printf( "%2d ", i + 1 );
+
+        // Row number, right aligned in two columns
+        *p++ = i + 1 >= 10 ? '0' + ( i + 1 ) / 10 : ' ';
+        *p++ = '0' + ( i + 1 ) % 10;
+        *p++ = ' ';
+
         for ( int j = INITIALIZE; j < b->size; j++ ) {
-            if ( grid[i][j] == WHITE_STONE ) {
-                printf( "\u25CB" );
-            } else if ( grid[i][j] == BLACK_STONE ) {
-                printf( "\u25CF" );
-            } else {
-                printf( "+" );
-            }
+            memcpy( p, board_glyphs[grid[i][j]], board_glyph_lengths[grid[i][j]] );
+            p += board_glyph_lengths[grid[i][j]];
 
             if ( j < b->size - 1 ) {
-                printf( "-" );
+                *p++ = '-';
             }
         }
-        printf( "\n" );
+        *p++ = '\n';
     }
 
+    // Column letters
+    *p++ = ' ';
+    *p++ = ' ';
     for ( int j = INITIALIZE; j < b->size; j++ ) {
+        *p++ = ' ';
+        *p++ = 'A' + j;
+    }
+    *p++ = '\n';
+
+    return p - frame;
+}
+
+void board_write( const char* frame, size_t length )
+{
+    // Anything already printed through stdio has to come out first
+    fflush( stdout );
 
-        if ( j == INITIALIZE ) {
-            printf( "   %c", 'A' + j );
-        // if printing the last letter in the line
-        } else if ( j == b->size - 1 ) {
-            printf( " %c\n", 'A' + j );
-        // if printing another iteration
-        } else {
-            printf( " %c", 'A' + j );
+    while ( length > INITIALIZE ) {
+
+        // Storing the number of bytes written by this call
+        ssize_t written = write( STDOUT_FILENO, frame, length );
+
+        if ( written < 0 && errno == EINTR ) {
+            continue;
+        } else if ( written <= 0 ) {
+            return;
         }
 
+        frame += written;
+        length -= written;
     }
+}
 
+void board_print( board* b, bool in_place ) 
+{   
+    // Storing the whole frame so it goes out with a single write
+    char frame[BOARD_FRAME_SIZE];
+
+    board_write( frame, board_render( b, in_place, frame ) );
 }
 
-unsigned char board_formal_coord( board* b, unsigned char x, unsigned char y, char* formal_coord ) 
+void board_view_init( board_view* v )
+{
+    v->drawn = false;
+}
+
+void board_view_print( board_view* v, board* b )
 {
+    // Storing the terminal size, left zero if it can't be read
+    struct winsize window = { INITIALIZE };
 
-    if ( x < INITIALIZE || x > b->size ) {
-        exit( COORDINATE_ERR );
+    if ( !isatty( STDOUT_FILENO ) ) {
+        board_print( b, true );
+        return;
+    }
+    ioctl( STDOUT_FILENO, TIOCGWINSZ, &window );
+
+    // Storing the frame to write
+    char frame[BOARD_FRAME_SIZE];
+    size_t length = INITIALIZE;
+
+    if ( !v->drawn || v->size != b->size || v->rows != window.ws_row || v->cols != window.ws_col ) {
+        v->drawn = true;
+        v->size = b->size;
+        v->rows = window.ws_row;
+        v->cols = window.ws_col;
+        memcpy( v->grid, b->grid, b->size * b->size );
+        board_write( frame, board_render( b, true, frame ) );
+        return;
     }
 
-    if ( y < INITIALIZE || y > b->size ) {
-        exit( COORDINATE_ERR );
+    for ( int i = INITIALIZE; i < b->size * b->size; i++ ) {
+
+        if ( v->grid[i] == b->grid[i] ) {
+            continue;
+        }
+        v->grid[i] = b->grid[i];
+
+        // Row y is printed on terminal line size - y, column x at terminal column 4 + 2x
+        length += snprintf( frame + length, BOARD_FRAME_SIZE - length, "\033[%d;%dH", b->size - i / b->size, 4 + 2 * ( i % b->size ) );
+        memcpy( frame + length, board_glyphs[b->grid[i]], board_glyph_lengths[b->grid[i]] );
+        length += board_glyph_lengths[b->grid[i]];
+
+        // A whole board of changes would overflow the buffer, send what is there first
+        if ( length > BOARD_FRAME_SIZE - LONG_DEFAULT_STRING_LENGTH ) {
+            board_write( frame, length );
+            length = INITIALIZE;
+        }
     }
-    
-    x = x + 'A';
-    y = y + 1;
 
-    sprintf( formal_coord, "%c%d", x, y );
+    // Back below the column letters, clearing the old status lines
+    length += snprintf( frame + length, BOARD_FRAME_SIZE - length, "\033[%d;1H\033[J", b->size + 2 );
+    board_write( frame, length );
+}
+
+unsigned char board_formal_coord( board* b, unsigned char x, unsigned char y, char* formal_coord ) 
+{
+
+    if ( x >= b->size || y >= b->size ) {
+        return COORDINATE_ERR;
+    }
+
+    formal_coord[board_format_coord( x, y, formal_coord )] = '\0';
 
-    
     return SUCCESS;
 
 }
 
+size_t board_format_coord( unsigned char x, unsigned char y, char* out )
+{
+    // Storing the number of the row, one or two digits
+    const char* number = board_numbers[y];
 
-unsigned char board_coord( board* b, const char* formal_coord, unsigned char* x, unsigned char* y )
+    out[0] = 'A' + x;
+    out[1] = number[0];
+    out[2] = number[1];
+
+    return number[1] ? 3 : 2;
+}
+
+size_t board_scan_coord( board* b, const char* p, const char* end, unsigned char* x, unsigned char* y )
 {
-    
-    // store the letter coord
-    char letter;
+    // Storing the start of the coordinate
+    const char* start = p;
 
-    // store the num coord
-    int num;
+    if ( p >= end || !( board_chars[( unsigned char ) *p] & BOARD_CHAR_LETTER ) ) {
+        return INITIALIZE;
+    }
 
-    // Use sscanf to parse the formal_coord string
-    if ( sscanf( formal_coord, "%c%d", &letter, &num ) != 2 ) { 
-        return FORMAL_COORDINATE_ERR;
+    // Storing the column and row read so far
+    unsigned int column = board_chars[( unsigned char ) *p++] & BOARD_CHAR_VALUE;
+    unsigned int row = INITIALIZE;
+
+    if ( p >= end || !( board_chars[( unsigned char ) *p] & BOARD_CHAR_DIGIT ) ) {
+        return INITIALIZE;
     }
 
-    // Convert letter to row index (x)
-    *x = letter - 'A';
+    // Leading zeros are allowed, but any row past the board stops the scan
+    while ( p < end && ( board_chars[( unsigned char ) *p] & BOARD_CHAR_DIGIT ) && row <= b->size ) {
+        row = row * 10 + ( board_chars[( unsigned char ) *p++] & BOARD_CHAR_VALUE );
+    }
 
-    // Convert num to column index (y)
-    *y = num - 1;
+    if ( ( p < end && !( board_chars[( unsigned char ) *p] & BOARD_CHAR_END ) ) || column >= b->size || row < 1 || row > b->size ) {
+        return INITIALIZE;
+    }
 
-    // Validate x and y coordinates
-    if ( *x < INITIALIZE || *x >= b->size || *y < INITIALIZE || *y >= b->size ) {
+    *x = column;
+    *y = row - 1;
+
+    return p - start;
+}
+
+size_t board_scan_coords( board* b, const char* data, size_t length, unsigned char* coords, size_t capacity, const char** stop )
+{
+    // Storing the current position and the end of the buffer
+    const char* p = data;
+    const char* end = data + length;
+
+    // Storing the number of coordinates read so far
+    size_t count = INITIALIZE;
+
+    for ( ;; ) {
+
+        while ( p < end && ( board_chars[( unsigned char ) *p] & BOARD_CHAR_END ) && *p != '\0' ) {
+            p++;
+        }
+
+        if ( p >= end || count >= capacity ) {
+            break;
+        }
+
+        // Storing the length of the coordinate at p
+        size_t scanned = board_scan_coord( b, p, end, &coords[2 * count], &coords[2 * count + 1] );
+
+        if ( scanned == INITIALIZE ) {
+            break;
+        }
+
+        p += scanned;
+        count++;
+    }
+
+    *stop = p;
+
+    return count;
+}
+
+unsigned char board_coord( board* b, const char* formal_coord, unsigned char* x, unsigned char* y )
+{
+    if ( board_scan_coord( b, formal_coord, formal_coord + strlen( formal_coord ), x, y ) == INITIALIZE ) {
         return FORMAL_COORDINATE_ERR;
     }
 
@@ -156,28 +381,148 @@ unsigned char board_get( board* b, unsigned char x, unsigned char y )
 }
 
 
-void board_set( board* b, unsigned char x, unsigned char y, unsigned char stone ) 
+/**
+ * This function flips the bit of the intersection x, y in all four bitboards of the given stone type
+ * and XORs its Zobrist number into the key, so the same call adds a stone or takes it away again.
+ * @param b A pointer to the board struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param stone The stone type (BLACK_STONE or WHITE_STONE).
+ */
+static void board_toggle( board* b, unsigned char x, unsigned char y, unsigned char stone )
+{
+    // Storing the colour index of the bitboards
+    int color = stone - 1;
+
+    b->rows[color][y] ^= ( uint32_t ) 1 << x;
+    b->cols[color][x] ^= ( uint32_t ) 1 << y;
+    b->diagonals[color][x - y + b->size - 1] ^= ( uint32_t ) 1 << x;
+    b->anti_diagonals[color][x + y] ^= ( uint32_t ) 1 << x;
+    b->key ^= board_zobrist[color][y * BOARD_MAX_SIZE + x];
+}
+
+
+unsigned char board_set( board* b, unsigned char x, unsigned char y, unsigned char stone ) 
 {
     if ( stone != BLACK_STONE && stone != WHITE_STONE ) {
-        exit( STONE_TYPE_ERR );
+        return STONE_TYPE_ERR;
+    }
+
+    if ( x >= b->size || y >= b->size ) {
+        return COORDINATE_ERR;
+    }
+
+    // Storing the previous occupation state of the intersection
+    unsigned char previous = board_get( b, x, y );
+
+    if ( previous == stone ) {
+        return SUCCESS;
+    }
+
+    if ( previous == EMPTY_INTERSECTION ) {
+        b->stones_count++;
+    } else {
+        board_toggle( b, x, y, previous );
     }
 
     ( ( unsigned char( * )[ b->size ] ) b->grid )[y][x] = stone;
+    board_toggle( b, x, y, stone );
+
+    return SUCCESS;
 }
 
 
+void board_unset( board* b, unsigned char x, unsigned char y )
+{
+    // Storing the occupation state being removed
+    unsigned char previous = board_get( b, x, y );
+
+    if ( previous == EMPTY_INTERSECTION ) {
+        return;
+    }
+
+    ( ( unsigned char( * )[ b->size ] ) b->grid )[y][x] = EMPTY_INTERSECTION;
+    board_toggle( b, x, y, previous );
+    b->stones_count--;
+}
+
+
+unsigned char board_copy( board* dest, board* src )
+{
+    if ( !dest || !src ) {
+        return NULL_POINTER_ERR;
+    }
+
+    if ( dest->size != src->size ) {
+        return BOARD_SIZE_ERR;
+    }
+
+    // Storing the grid of dest so the struct copy doesn't take src's
+    unsigned char* grid = dest->grid;
+
+    *dest = *src;
+    dest->grid = grid;
+    memcpy( dest->grid, src->grid, src->size * src->size * sizeof( unsigned char ) );
+
+    return SUCCESS;
+}
+
 bool board_is_full( board* b )
 {
-    unsigned char ( *grid )[b->size] = ( unsigned char ( * )[b->size] ) b->grid;
+    return b->stones_count == b->size * b->size;
+}
 
-    for ( int i = INITIALIZE; i < b->size; i++ ) {
-        for ( int j = INITIALIZE; j < b->size; j++ ) {
 
-            if ( grid[i][j] != WHITE_STONE && grid[i][j] != BLACK_STONE ) {
-                return false;
-            }
-        }
+/**
+ * This function returns the mask of the bits of the line through x and y in the given direction
+ * that correspond to intersections on the board.
+ * @param b A pointer to the board struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param direction The direction of the line.
+ * @return uint32_t The mask of the on-board bits.
+ */
+static uint32_t board_line_valid( board* b, unsigned char x, unsigned char y, unsigned char direction )
+{
+    // Storing the mask of a full row
+    uint32_t full = ( ( uint32_t ) 1 << b->size ) - 1;
+
+    // Storing the distance from the main diagonal
+    int offset = x - y;
+
+    if ( direction == DIRECTION_DIAGONAL ) {
+        // x runs from max(0, offset) to size - 1 + min(0, offset)
+        return offset >= INITIALIZE ? full & ~( ( ( uint32_t ) 1 << offset ) - 1 ) : full >> -offset;
+    }
+
+    if ( direction == DIRECTION_ANTI_DIAGONAL ) {
+        // x runs from max(0, x + y - size + 1) to min(size - 1, x + y)
+        int sum = x + y;
+        return sum < b->size ? full >> ( b->size - 1 - sum ) : full & ~( ( ( uint32_t ) 1 << ( sum - b->size + 1 ) ) - 1 );
     }
 
-    return true;
-}
\ No newline at end of file
+    return full;
+}
+
+
+uint32_t board_line( board* b, unsigned char x, unsigned char y, unsigned char direction, unsigned char stone )
+{
+    if ( stone == EMPTY_INTERSECTION ) {
+        return board_line_valid( b, x, y, direction ) &
+               ~( board_line( b, x, y, direction, BLACK_STONE ) | board_line( b, x, y, direction, WHITE_STONE ) );
+    }
+
+    // Storing the colour index of the bitboards
+    int color = stone - 1;
+
+    switch ( direction ) {
+        case DIRECTION_HORIZONTAL:
+            return b->rows[color][y];
+        case DIRECTION_VERTICAL:
+            return b->cols[color][x];
+        case DIRECTION_DIAGONAL:
+            return b->diagonals[color][x - y + b->size - 1];
+        default:
+            return b->anti_diagonals[color][x + y];
+    }
+}
@@ -1,43 +1,126 @@
 #ifndef _BOARD_H_
 #define _BOARD_H_
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #define EMPTY_INTERSECTION 0
 #define BLACK_STONE 1
 #define WHITE_STONE 2
 #define clear() printf("\033[H\033[J")
 
+#define BOARD_MAX_SIZE 19
+#define BOARD_MAX_DIAGONALS ( 2 * BOARD_MAX_SIZE - 1 )
+#define BOARD_COLORS 2
+#define BOARD_ZOBRIST_SEED 0x9E3779B97F4A7C15ULL
+#define BOARD_DIRECTIONS 4
+#define DIRECTION_HORIZONTAL 0
+#define DIRECTION_VERTICAL 1
+#define DIRECTION_DIAGONAL 2
+#define DIRECTION_ANTI_DIAGONAL 3
+#define BOARD_FRAME_SIZE 2048
+#define BOARD_COORD_LENGTH 3
+#define BOARD_CHAR_VALUE 0x1F
+#define BOARD_CHAR_DIGIT 0x20
+#define BOARD_CHAR_LETTER 0x40
+#define BOARD_CHAR_END 0x80
+
+/**
+ * Bit index of the intersection x, y inside the line bitmask returned by board_line() for the given direction.
+ */
+#define board_line_index(direction, x, y) ((direction) == DIRECTION_VERTICAL ? (y) : (x))
+
+/**
+ * The grid keeps one byte per intersection, the bitboards keep the same information as one bitmask per line and colour.
+ * rows[c][y] has bit x set, cols[c][x] has bit y set, diagonals[c][x - y + size - 1] and anti_diagonals[c][x + y] have bit x set.
+ * Index c is the stone type minus one. Both stores are kept in sync by board_set(),
+ * which also maintains stones_count, the number of occupied intersections, and key, the Zobrist hash of the position.
+ * The key starts from a value that depends on the size only and XORs in a fixed 64-bit number per stone type and intersection;
+ * the numbers come from a fixed seed, so equal positions have equal keys across runs and files.
+ */
 typedef struct {
     unsigned char size;
     unsigned char* grid;
+    unsigned short stones_count;
+    uint64_t key;
+    uint32_t rows[BOARD_COLORS][BOARD_MAX_SIZE];
+    uint32_t cols[BOARD_COLORS][BOARD_MAX_SIZE];
+    uint32_t diagonals[BOARD_COLORS][BOARD_MAX_DIAGONALS];
+    uint32_t anti_diagonals[BOARD_COLORS][BOARD_MAX_DIAGONALS];
 } board;
 
+/**
+ * What a terminal was last shown of a board, kept by board_view_print() so it only has to redraw what changed.
+ * rows and cols are the terminal size at the last full redraw.
+ */
+typedef struct {
+    bool drawn;
+    unsigned char size;
+    unsigned short rows;
+    unsigned short cols;
+    unsigned char grid[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+} board_view;
+
 
 /**
  * This function creates a new dynamically allocated board struct,
  * initializes board.size with the parameter size, initializes board.grid with a new dynamically allocated array,
  * initializes all grid intersections with EMPTY_INTERSECTION, finally it returns the struct created.
- * If an invalid size is given, exit with the code BOARD_SIZE_ERR as defined in error-codes.h.
+ * If an invalid size is given (0 or more than BOARD_MAX_SIZE), or memory runs out, return NULL instead.
  * @param size The size of the board to be created.
- * @return board* A pointer to the newly created board struct.
+ * @return board* A pointer to the newly created board struct, or NULL.
  */
 board* board_create(unsigned char size);
 
 /**
  * This function frees the memory of a dynamically allocated board struct,
  * it also frees the memory of its dynamically allocated grid field.
- * If the pointer b is NULL, exit with the code NULL_POINTER_ERR as defined in error-codes.h.
+ * If the pointer b is NULL, return NULL_POINTER_ERR as defined in error-codes.h, otherwise return SUCCESS.
  * @param b A pointer to the board struct to be deleted.
+ * @return unsigned char SUCCESS, or NULL_POINTER_ERR.
  */
-void board_delete(board* b);
+unsigned char board_delete(board* b);
 
 /**
  * This function prints the board in the format specified in section Printing the Board with Stones.
- * If in_place is true, it clears the terminal first.
+ * If in_place is true, it clears the terminal first. The frame is built with board_render() and goes out with board_write().
  * @param b A pointer to the board struct to be printed.
  * @param in_place A boolean indicating whether to clear the terminal before printing.
  */
 void board_print(board* b, bool in_place);
 
+/**
+ * This function renders the board as board_print() prints it into frame, the clear() sequence included if in_place is true.
+ * @param b A pointer to the board struct to be rendered.
+ * @param in_place A boolean indicating whether the frame starts by clearing the terminal.
+ * @param frame A buffer of at least BOARD_FRAME_SIZE bytes, not NUL-terminated.
+ * @return size_t The length of the frame.
+ */
+size_t board_render(board* b, bool in_place, char* frame);
+
+/**
+ * This function flushes stdout and writes length bytes of frame to the standard output with as few write() calls as possible,
+ * normally one.
+ * @param frame The bytes to write.
+ * @param length The number of bytes.
+ */
+void board_write(const char* frame, size_t length);
+
+/**
+ * This function prepares a view for its first board_view_print(), which will then draw the full board.
+ * @param v A pointer to the view.
+ */
+void board_view_init(board_view* v);
+
+/**
+ * This function brings the terminal up to date with board b like board_print(b, true), but only sends what changed since the last call:
+ * a cursor-positioning escape and a glyph for every intersection that changed, then the cursor is put back below the board
+ * and everything after it, the status lines, is cleared.
+ * The first call, a change of board size, a terminal resize, or a standard output that isn't a terminal draw the full board instead.
+ * @param v A pointer to the view of the terminal.
+ * @param b A pointer to the board struct to be printed.
+ */
+void board_view_print(board_view* v, board* b);
+
 /**
  * This function converts the horizontal coordinate x and vertical coordinate y
  * for a board.grid to a "letter + number" formal coordinate,
@@ -52,10 +135,47 @@ void board_print(board* b, bool in_place);
  */
 unsigned char board_formal_coord(board* b, unsigned char x, unsigned char y, char* formal_coord);
 
+/**
+ * This function writes the "letter + number" formal coordinate of x and y to out, without a terminating NUL,
+ * from lookup tables rather than through printf. x and y must be less than BOARD_MAX_SIZE.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param out A buffer of at least BOARD_COORD_LENGTH bytes.
+ * @return size_t The number of bytes written, 2 or 3.
+ */
+size_t board_format_coord(unsigned char x, unsigned char y, char* out);
+
+/**
+ * This function reads a "letter + number" formal coordinate at p, reading no further than end, with a character class table
+ * instead of scanf, so it doesn't depend on the locale. The letter is a capital, the number is decimal without a sign;
+ * the coordinate has to be followed by end, whitespace or a NUL, and has to lie on board b.
+ * @param b A pointer to the board struct.
+ * @param p The first character of the coordinate.
+ * @param end The end of the buffer.
+ * @param x A pointer to store the horizontal coordinate.
+ * @param y A pointer to store the vertical coordinate.
+ * @return size_t The number of characters read, or 0 if there is no valid coordinate at p.
+ */
+size_t board_scan_coord(board* b, const char* p, const char* end, unsigned char* x, unsigned char* y);
+
+/**
+ * This function reads whitespace-separated formal coordinates from the length bytes at data in one pass, like board_scan_coord(),
+ * and stores them as x, y pairs in coords. It stops at the end of the buffer, at the first thing that isn't a valid coordinate,
+ * or once capacity coordinates have been read, and stores where it stopped in stop.
+ * @param b A pointer to the board struct.
+ * @param data The buffer.
+ * @param length The length of the buffer.
+ * @param coords A buffer for 2 * capacity bytes.
+ * @param capacity The largest number of coordinates to read.
+ * @param stop A pointer to store the position the scan stopped at, data + length if it read everything.
+ * @return size_t The number of coordinates read.
+ */
+size_t board_scan_coords(board* b, const char* data, size_t length, unsigned char* coords, size_t capacity, const char** stop);
+
 /**
  * This function converts a "letter + number" formal coordinate string formal_coord to the horizontal
  * and vertical coordinates for a board.grid, and stores the results in x and y that are passed by reference.
- * Finally it returns SUCCESS.
+ * Finally it returns SUCCESS. The string is read by board_scan_coord(), anything after whitespace following the coordinate is ignored.
  * If formal_coord is invalid for board b, return FORMAL_COORDINATE_ERR instead.
  * Return codes are defined in error-codes.h.
  * @param b A pointer to the board struct.
@@ -78,18 +198,56 @@ unsigned char board_get(board* b, unsigned char x, unsigned char y);
 
 /**
  * This function stores the intersection occupation state stone to a board.grid at the given horizontal and vertical coordinate pair x and y.
- * If stone is neither BLACK_STONE nor WHITE_STONE, exit with the code STONE_TYPE_ERR as defined in error-codes.h.
+ * If stone is neither BLACK_STONE nor WHITE_STONE, return STONE_TYPE_ERR as defined in error-codes.h;
+ * if x or y is off the board, return COORDINATE_ERR. Otherwise return SUCCESS.
  * @param b A pointer to the board struct.
  * @param x The horizontal coordinate.
  * @param y The vertical coordinate.
  * @param stone The stone type (BLACK_STONE or WHITE_STONE).
+ * @return unsigned char SUCCESS, STONE_TYPE_ERR or COORDINATE_ERR.
  */
-void board_set(board* b, unsigned char x, unsigned char y, unsigned char stone);
+unsigned char board_set(board* b, unsigned char x, unsigned char y, unsigned char stone);
+
+/**
+ * This function removes the stone at the given horizontal and vertical coordinate pair x and y from a board.grid,
+ * leaving the intersection as EMPTY_INTERSECTION. Removing from an empty intersection does nothing.
+ * @param b A pointer to the board struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ */
+void board_unset(board* b, unsigned char x, unsigned char y);
+
+/**
+ * This function makes dest the same position as src: grid, bitboards, stones_count and key.
+ * Both boards keep their own grid, so dest can be restored from src any number of times.
+ * If either pointer is NULL, return NULL_POINTER_ERR; if the sizes differ, return BOARD_SIZE_ERR. Otherwise return SUCCESS.
+ * @param dest A pointer to the board struct to overwrite.
+ * @param src A pointer to the board struct to copy.
+ * @return unsigned char SUCCESS, NULL_POINTER_ERR or BOARD_SIZE_ERR.
+ */
+unsigned char board_copy(board* dest, board* src);
 
 /**
  * This function returns true if all intersections of a board.grid are occupied by a stone, otherwise it returns false.
+ * It compares the stone count maintained by board_set() against the number of intersections, so it runs in constant time.
  * @param b A pointer to the board struct.
  * @return bool true if the board is full, otherwise false.
  */
 bool board_is_full(board* b);
+
+/**
+ * This function returns the bitmask of the line through x and y in the given direction
+ * (DIRECTION_HORIZONTAL, DIRECTION_VERTICAL, DIRECTION_DIAGONAL or DIRECTION_ANTI_DIAGONAL).
+ * A bit is set for every intersection of the line occupied by stone; if stone is EMPTY_INTERSECTION,
+ * a bit is set for every empty intersection of the line that lies on the board.
+ * The intersection x, y itself is at bit board_line_index(direction, x, y), and the bit index grows
+ * with x (or with y for DIRECTION_VERTICAL); the diagonal runs towards increasing y, the anti-diagonal towards decreasing y.
+ * @param b A pointer to the board struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param direction The direction of the line.
+ * @param stone The intersection occupation state to select.
+ * @return uint32_t The bitmask of the line.
+ */
+uint32_t board_line(board* b, unsigned char x, unsigned char y, unsigned char direction, unsigned char stone);
 #endif
@@ -0,0 +1,93 @@
+/**
+* @file check-archive.c
+* @author Sadia Ahmed (sahmed23)
+* This file checks that archives with a corrupt trailer are read by walking their records
+* instead of trusting the index, run by make check
+*/
+
+#include "archive.h"
+#include "game.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CHECK_ARCHIVE_PATH "check.gmka"
+
+/**
+ * Writes an archive holding no record and a trailer with the given index offset and number of games, then opens it.
+ * @param index The offset of the index in the trailer.
+ * @param count The number of games in the trailer.
+ * @return bool true if the archive opens with no game, as an archive whose trailer is ignored.
+ */
+static bool check_trailer( uint64_t index, uint32_t count )
+{
+    // Storing the header and the trailer, the whole file
+    unsigned char bytes[ARCHIVE_HEADER_SIZE + ARCHIVE_TRAILER_SIZE] = { 'G', 'R', ARCHIVE_VERSION, INITIALIZE };
+    unsigned char* trailer = bytes + ARCHIVE_HEADER_SIZE;
+
+    for ( int i = INITIALIZE; i < 8; i++ ) {
+        trailer[i] = ( index >> ( 8 * i ) ) & 0xFF;
+    }
+    for ( int i = INITIALIZE; i < 4; i++ ) {
+        trailer[8 + i] = ( count >> ( 8 * i ) ) & 0xFF;
+    }
+    memcpy( trailer + 12, ARCHIVE_INDEX_MAGIC, strlen( ARCHIVE_INDEX_MAGIC ) );
+    trailer[14] = ARCHIVE_VERSION;
+
+    FILE* fp = fopen( CHECK_ARCHIVE_PATH, "wb" );
+
+    if ( !fp ) {
+        return false;
+    }
+
+    // Storing whether the file was written
+    bool written = fwrite( bytes, sizeof( bytes ), 1, fp ) == 1;
+
+    if ( fclose( fp ) != 0 || !written ) {
+        return false;
+    }
+
+    archive* a = NULL;
+
+    // Storing the status of the open
+    unsigned char status = archive_open( CHECK_ARCHIVE_PATH, &a );
+
+    // Storing whether the archive was read as holding no game
+    bool empty = status == SUCCESS && a->count == INITIALIZE;
+
+    if ( a ) {
+        archive_close( a );
+    }
+
+    return empty;
+}
+
+/**
+ * Opens archives whose trailer points the index outside the file, with offsets and counts that only add up
+ * to the file length once they wrap around.
+ * @return SUCCESS, or FILE_INPUT_ERR if an archive isn't read as expected
+ */
+int main( void )
+{
+    // Storing the trailers to check, each fitting the 20-byte file only modulo 2^64
+    uint64_t indexes[] = { UINT64_C( 0xFFFFFFFFFFFFFFFC ), UINT64_C( 0xFFFFFFFFF8000004 ) };
+    uint32_t counts[] = { 1, UINT32_C( 0x01000000 ) };
+
+    // Storing whether every archive was read as expected
+    bool passed = true;
+
+    for ( size_t i = INITIALIZE; i < sizeof( counts ) / sizeof( counts[0] ); i++ ) {
+        if ( !check_trailer( indexes[i], counts[i] ) ) {
+            printf( "The archive with index %llx and %lu games isn't read as empty.\n",
+                    ( unsigned long long ) indexes[i], ( unsigned long ) counts[i] );
+            passed = false;
+        }
+    }
+
+    remove( CHECK_ARCHIVE_PATH );
+
+    return passed ? SUCCESS : FILE_INPUT_ERR;
+}
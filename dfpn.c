@@ -0,0 +1,1003 @@
+/**
+* @file dfpn.c
+* @author Sadia Ahmed (sahmed23)
+* This file proves or disproves wins with depth-first proof-number search
+* over a table of proof and disproof numbers that can be saved and resumed
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "dfpn.h"
+#include "vcf.h"
+#include "vct.h"
+#include "game.h"
+#include "board.h"
+#include "pattern.h"
+#include "transposition.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+// Set by dfpn_interrupt() to stop the running solve, only read and written with atomic builtins since every thread polls it
+static sig_atomic_t dfpn_interrupted = INITIALIZE;
+
+// Ordering score of a point for each line pattern it would make, indexed by pattern class
+static const int dfpn_pattern_score[] = { 0, 4, 6, 20, 20, 100, 0 };
+
+/**
+ * The bookkeeping of one solve, shared by its threads under lock. nodes counts the nodes the threads have reported,
+ * threads the threads searching.
+ */
+typedef struct {
+    dfpn_table* table;
+    const dfpn_limits* limits;
+    time_t start;
+    time_t saved;
+    unsigned long nodes;
+    unsigned int threads;
+    bool stopped;
+    unsigned char status;
+    pthread_mutex_t lock;
+} dfpn_context;
+
+/**
+ * One thread of a solve, searching its own game. nodes counts the nodes it visited, pending those not reported to the context yet,
+ * and budget how many it may visit before it reports them.
+ */
+typedef struct {
+    dfpn_context* context;
+    game* game;
+    unsigned long nodes;
+    unsigned long pending;
+    unsigned long budget;
+    bool stopped;
+} dfpn_worker;
+
+/**
+ * A move of a node: where it is played, the key of the position it leads to, its ordering score,
+ * and DFPN_PROVEN or DFPN_DISPROVEN if it ends the game, DFPN_UNKNOWN otherwise.
+ */
+typedef struct {
+    unsigned char x;
+    unsigned char y;
+    unsigned char outcome;
+    int score;
+    uint64_t key;
+} dfpn_child;
+
+/**
+ * This function returns the key of the position of game g in the table.
+ * @param g A pointer to the game struct.
+ * @return uint64_t The key.
+ */
+static uint64_t dfpn_key( game* g )
+{
+    return transposition_key( g ) ^ DFPN_KEY;
+}
+
+/**
+ * This function returns the lock guarding the bucket of key in table t.
+ * @param t A pointer to the table.
+ * @param key The key of the position.
+ * @return pthread_mutex_t* A pointer to the lock.
+ */
+static pthread_mutex_t* dfpn_lock( dfpn_table* t, uint64_t key )
+{
+    return &t->locks[( key & t->mask ) % DFPN_LOCK_STRIPES];
+}
+
+/**
+ * This function looks key up in table t and stores its numbers in pn and dn, 1 and 1 for a position never seen.
+ * @param t A pointer to the table.
+ * @param key The key of the position.
+ * @param pn A pointer to store the proof number.
+ * @param dn A pointer to store the disproof number.
+ * @param work A pointer to store the work of the entry, 0 for a position never seen, or NULL.
+ * @param searchers A pointer to store the number of threads in the bucket of the position, or NULL.
+ * @return bool true if the position is in the table.
+ */
+static bool dfpn_probe( dfpn_table* t, uint64_t key, uint32_t* pn, uint32_t* dn, uint64_t* work, uint16_t* searchers )
+{
+    // Storing the bucket the key goes to and whether the key is in it
+    dfpn_entry* bucket = &t->entries[( key & t->mask ) * DFPN_BUCKET_ENTRIES];
+    bool found = false;
+
+    *pn = 1;
+    *dn = 1;
+    if ( work ) {
+        *work = INITIALIZE;
+    }
+
+    pthread_mutex_lock( dfpn_lock( t, key ) );
+
+    for ( int i = INITIALIZE; i < DFPN_BUCKET_ENTRIES && !found; i++ ) {
+        if ( bucket[i].key == key ) {
+            *pn = bucket[i].pn;
+            *dn = bucket[i].dn;
+            if ( work ) {
+                *work = bucket[i].work;
+            }
+            found = true;
+        }
+    }
+    if ( searchers ) {
+        *searchers = t->searchers[key & t->mask];
+    }
+
+    pthread_mutex_unlock( dfpn_lock( t, key ) );
+
+    return found;
+}
+
+/**
+ * This function stores the numbers of the position key in table t, replacing the entry of the bucket with the least work if it is new.
+ * A solved position keeps its numbers, another thread may have settled it in the meantime.
+ * @param t A pointer to the table.
+ * @param key The key of the position.
+ * @param pn The proof number.
+ * @param dn The disproof number.
+ * @param work The number of nodes spent on the position.
+ */
+static void dfpn_store( dfpn_table* t, uint64_t key, uint32_t pn, uint32_t dn, uint64_t work )
+{
+    // Storing the bucket the key goes to and the entry chosen in it
+    dfpn_entry* bucket = &t->entries[( key & t->mask ) * DFPN_BUCKET_ENTRIES];
+    dfpn_entry* victim = &bucket[INITIALIZE];
+
+    pthread_mutex_lock( dfpn_lock( t, key ) );
+
+    for ( int i = INITIALIZE; i < DFPN_BUCKET_ENTRIES; i++ ) {
+        if ( bucket[i].key == key ) {
+            victim = &bucket[i];
+            break;
+        }
+        if ( bucket[i].work < victim->work ) {
+            victim = &bucket[i];
+        }
+    }
+
+    if ( victim->key == key && ( victim->pn == INITIALIZE || victim->dn == INITIALIZE ) ) {
+        victim->work = work > victim->work ? work : victim->work;
+    } else {
+        victim->key = key;
+        victim->pn = pn;
+        victim->dn = dn;
+        victim->work = work;
+    }
+
+    pthread_mutex_unlock( dfpn_lock( t, key ) );
+}
+
+/**
+ * This function counts a thread in or out of the bucket of the position key in table t. The count sticks at UINT16_MAX
+ * rather than wrap, and never goes below 0.
+ * @param t A pointer to the table.
+ * @param key The key of the position.
+ * @param entering true when the thread enters the position, false when it leaves.
+ */
+static void dfpn_visit( dfpn_table* t, uint64_t key, bool entering )
+{
+    pthread_mutex_lock( dfpn_lock( t, key ) );
+
+    // Storing the count of the bucket
+    uint16_t* searchers = &t->searchers[key & t->mask];
+
+    if ( entering && *searchers < UINT16_MAX ) {
+        ( *searchers )++;
+    } else if ( !entering && *searchers > INITIALIZE ) {
+        ( *searchers )--;
+    }
+
+    pthread_mutex_unlock( dfpn_lock( t, key ) );
+}
+
+/**
+ * This function returns a proof or disproof number as it looks to a thread choosing a move, with the virtual loss of the threads
+ * already searching the position: 1 + number / DFPN_VIRTUAL_SHARE more for each, short of DFPN_INFINITY.
+ * @param number The number.
+ * @param searchers The number of threads in the position.
+ * @return uint32_t The number with the virtual loss.
+ */
+static uint32_t dfpn_virtual( uint32_t number, uint16_t searchers )
+{
+    // Storing the number with the loss, wide enough not to overflow
+    uint64_t seen = number + ( uint64_t ) searchers * ( number / DFPN_VIRTUAL_SHARE + 1 );
+
+    if ( number >= DFPN_INFINITY ) {
+        return DFPN_INFINITY;
+    }
+
+    return seen >= DFPN_INFINITY ? DFPN_INFINITY - 1 : ( uint32_t ) seen;
+}
+
+/**
+ * This function returns the outcome for the attacker of game g once a move has ended it.
+ * @param g A pointer to the game struct, after the move.
+ * @param attacker The attacker's stone type.
+ * @return unsigned char DFPN_PROVEN if the attacker won, DFPN_DISPROVEN if the attacker lost or the board is full.
+ */
+static unsigned char dfpn_outcome( game* g, unsigned char attacker )
+{
+    if ( g->state == GAME_STATE_FORBIDDEN ) {
+        return attacker == WHITE_STONE ? DFPN_PROVEN : DFPN_DISPROVEN;
+    }
+
+    return g->winner == attacker ? DFPN_PROVEN : DFPN_DISPROVEN;
+}
+
+/**
+ * This function scores the empty point x, y for ordering the moves of the side to move,
+ * by the line patterns a stone there would make for it and for the opponent.
+ * @param g A pointer to the game struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @return int The score of the point.
+ */
+static int dfpn_point_score( game* g, unsigned char x, unsigned char y )
+{
+    // Storing the side to move and the opponent, with their rules
+    unsigned char own = g->stone;
+    unsigned char other = own == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+    unsigned char own_rule = g->type == GAME_RENJU && own == BLACK_STONE ? PATTERN_EXACT_FIVE : PATTERN_FIVE_OR_MORE;
+    unsigned char other_rule = g->type == GAME_RENJU && other == BLACK_STONE ? PATTERN_EXACT_FIVE : PATTERN_FIVE_OR_MORE;
+
+    // Storing the score
+    int score = INITIALIZE;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+        score += 2 * dfpn_pattern_score[pattern_type( pattern_line( g->board, x, y, direction, own, own_rule ) )];
+        score += dfpn_pattern_score[pattern_type( pattern_line( g->board, x, y, direction, other, other_rule ) )];
+    }
+
+    return score;
+}
+
+/**
+ * This function stores in points the empty intersections within DFPN_NEIGHBOURHOOD of a stone, or the center of an empty board.
+ * @param g A pointer to the game struct.
+ * @param points A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes.
+ * @return int The number of points.
+ */
+static int dfpn_neighbourhood( game* g, unsigned char* points )
+{
+    // Storing the size of the board and the mask of a full row
+    int size = g->board->size;
+    uint32_t full = ( ( uint32_t ) 1 << size ) - 1;
+
+    // Storing the occupied intersections of each row, and the same spread sideways
+    uint32_t occupied[BOARD_MAX_SIZE];
+    uint32_t spread[BOARD_MAX_SIZE];
+
+    // Storing the number of points found
+    int count = INITIALIZE;
+
+    if ( g->board->stones_count == INITIALIZE ) {
+        points[INITIALIZE] = size / 2;
+        points[1] = size / 2;
+        return 1;
+    }
+
+    for ( int y = INITIALIZE; y < size; y++ ) {
+        occupied[y] = board_line( g->board, INITIALIZE, y, DIRECTION_HORIZONTAL, BLACK_STONE ) |
+                      board_line( g->board, INITIALIZE, y, DIRECTION_HORIZONTAL, WHITE_STONE );
+        spread[y] = occupied[y];
+        for ( int k = 1; k <= DFPN_NEIGHBOURHOOD; k++ ) {
+            spread[y] |= ( occupied[y] << k ) | ( occupied[y] >> k );
+        }
+    }
+
+    for ( int y = INITIALIZE; y < size; y++ ) {
+
+        // Storing the empty intersections of the row near a stone
+        uint32_t near = INITIALIZE;
+
+        for ( int k = -DFPN_NEIGHBOURHOOD; k <= DFPN_NEIGHBOURHOOD; k++ ) {
+            if ( y + k >= INITIALIZE && y + k < size ) {
+                near |= spread[y + k];
+            }
+        }
+        near &= full & ~occupied[y];
+
+        while ( near ) {
+            points[2 * count] = __builtin_ctz( near );
+            points[2 * count + 1] = y;
+            count++;
+            near &= near - 1;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * This function lists the moves of the side to move in game g, or solves the position outright.
+ * A five point wins, two five points of the opponent lose, a single one must be blocked, threes must be answered with
+ * vct_replies() (none left loses), and otherwise every point of dfpn_neighbourhood() is a move, best scored first.
+ * @param g A pointer to the game struct.
+ * @param attacker The attacker's stone type.
+ * @param children The buffer to store the moves, BOARD_MAX_SIZE * BOARD_MAX_SIZE entries.
+ * @param outcome A pointer to store the outcome for the attacker if the position is solved without moves.
+ * @return int The number of moves, 0 if the position is solved, or -1 if a move can't be stored for lack of memory.
+ */
+static int dfpn_children( game* g, unsigned char attacker, dfpn_child* children, unsigned char* outcome )
+{
+    // Storing the side to move and the opponent
+    unsigned char own = g->stone;
+    unsigned char other = own == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    // Storing the points found by the scans
+    unsigned char points[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    unsigned char threats[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+
+    // Storing the number of moves and whether they need ordering
+    int count = INITIALIZE;
+    bool forced = true;
+
+    *outcome = DFPN_UNKNOWN;
+
+    if ( vcf_fives( g, own, points ) > INITIALIZE ) {
+        *outcome = own == attacker ? DFPN_PROVEN : DFPN_DISPROVEN;
+        return INITIALIZE;
+    }
+
+    count = vcf_fives( g, other, points );
+
+    // Two five points can't both be blocked
+    if ( count > 1 ) {
+        *outcome = other == attacker ? DFPN_PROVEN : DFPN_DISPROVEN;
+        return INITIALIZE;
+    }
+
+    if ( count == INITIALIZE ) {
+
+        // Storing the opponent's straight four points
+        int threats_count = vcf_straight_fours( g, other, threats );
+
+        if ( threats_count > INITIALIZE ) {
+            count = vct_replies( g, threats, threats_count, points );
+
+            // Threes with no reply can't be stopped
+            if ( count == INITIALIZE ) {
+                *outcome = other == attacker ? DFPN_PROVEN : DFPN_DISPROVEN;
+                return INITIALIZE;
+            }
+        } else {
+            count = dfpn_neighbourhood( g, points );
+            forced = false;
+        }
+    }
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        children[i].x = points[2 * i];
+        children[i].y = points[2 * i + 1];
+        children[i].score = forced ? INITIALIZE : dfpn_point_score( g, children[i].x, children[i].y );
+
+        if ( !game_place_stone( g, children[i].x, children[i].y ) ) {
+            return -1;
+        }
+        children[i].outcome = g->state == GAME_STATE_PLAYING ? DFPN_UNKNOWN : dfpn_outcome( g, attacker );
+        children[i].key = dfpn_key( g );
+        game_unplace_stone( g );
+    }
+
+    for ( int i = 1; i < count; i++ ) {
+
+        // Storing the move being inserted
+        dfpn_child current = children[i];
+        int j = i - 1;
+
+        while ( j >= INITIALIZE && children[j].score < current.score ) {
+            children[j + 1] = children[j];
+            j--;
+        }
+        children[j + 1] = current;
+    }
+
+    return count;
+}
+
+/**
+ * This function reports the pending nodes of a thread to the solve, and checks the budget: the solve stops once it is interrupted,
+ * its node or time budget runs out, or a thread has stopped it. It also saves the checkpoint when it is due,
+ * and gives the thread its next budget: DFPN_CLOCK_INTERVAL nodes, or its share of the nodes left if that is less.
+ * @param worker A pointer to the thread.
+ */
+static void dfpn_report( dfpn_worker* worker )
+{
+    // Storing the solve, its budget and the time now
+    dfpn_context* context = worker->context;
+    const dfpn_limits* limits = context->limits;
+    time_t now = time( NULL );
+
+    pthread_mutex_lock( &context->lock );
+
+    context->nodes += worker->pending;
+    worker->pending = INITIALIZE;
+
+    if ( __atomic_load_n( &dfpn_interrupted, __ATOMIC_RELAXED ) || ( limits->max_nodes && context->nodes >= limits->max_nodes ) ||
+         ( limits->max_seconds && ( unsigned long ) ( now - context->start ) >= limits->max_seconds ) ) {
+        context->stopped = true;
+    }
+    if ( limits->checkpoint && limits->checkpoint_seconds && ( unsigned long ) ( now - context->saved ) >= limits->checkpoint_seconds ) {
+        context->status = dfpn_table_save( context->table, limits->checkpoint );
+        context->saved = now;
+    }
+
+    worker->stopped = worker->stopped || context->stopped;
+    worker->budget = DFPN_CLOCK_INTERVAL;
+
+    if ( limits->max_nodes && context->nodes < limits->max_nodes ) {
+
+        // Storing the share of the nodes left
+        unsigned long share = ( limits->max_nodes - context->nodes ) / context->threads;
+
+        worker->budget = share < 1 ? 1 : share < DFPN_CLOCK_INTERVAL ? share : DFPN_CLOCK_INTERVAL;
+    }
+
+    pthread_mutex_unlock( &context->lock );
+}
+
+/**
+ * This function counts a node of a thread and returns true once it must stop, reporting to the solve when its budget is used up.
+ * @param worker A pointer to the thread.
+ * @return bool true if the thread must stop.
+ */
+static bool dfpn_tick( dfpn_worker* worker )
+{
+    worker->nodes++;
+    worker->pending++;
+
+    if ( __atomic_load_n( &dfpn_interrupted, __ATOMIC_RELAXED ) ) {
+        worker->stopped = true;
+    }
+    if ( worker->pending >= worker->budget ) {
+        dfpn_report( worker );
+    }
+
+    return worker->stopped;
+}
+
+/**
+ * This function adds a number to a sum of proof or disproof numbers, where DFPN_INFINITY absorbs everything
+ * and a finite sum stops just below it.
+ * @param sum The sum so far.
+ * @param number The number to add.
+ * @return uint32_t The new sum.
+ */
+static uint32_t dfpn_add( uint32_t sum, uint32_t number )
+{
+    if ( sum >= DFPN_INFINITY || number >= DFPN_INFINITY ) {
+        return DFPN_INFINITY;
+    }
+
+    return sum + number >= DFPN_INFINITY ? DFPN_INFINITY - 1 : sum + number;
+}
+
+/**
+ * This function searches the position of game g until its proof number reaches th_pn or its disproof number reaches th_dn,
+ * and stores both in pn and dn and in the table. The attacker moves at OR nodes, where the proof number is the smallest of
+ * the moves' and the disproof number their sum; the defender moves at AND nodes, where it is the other way round.
+ * The move with the smallest number, counting the virtual loss of the other threads in it, is searched with thresholds
+ * that send the search back here as soon as another move looks better.
+ * @param worker A pointer to the thread.
+ * @param g A pointer to the game struct.
+ * @param th_pn The proof number threshold.
+ * @param th_dn The disproof number threshold.
+ * @param pn A pointer to store the proof number.
+ * @param dn A pointer to store the disproof number.
+ */
+static void dfpn_mid( dfpn_worker* worker, game* g, uint32_t th_pn, uint32_t th_dn, uint32_t* pn, uint32_t* dn )
+{
+    // Storing the table, the key of the position and the nodes visited before it
+    dfpn_table* table = worker->context->table;
+    uint64_t key = dfpn_key( g );
+    unsigned long start = worker->nodes;
+
+    // Storing whether the position is in the table and the work it holds, read before deeper stores can replace it
+    uint64_t work;
+    bool seen = dfpn_probe( table, key, pn, dn, &work, NULL );
+
+    if ( *pn == INITIALIZE || *dn == INITIALIZE || dfpn_tick( worker ) ) {
+        return;
+    }
+
+    // Storing the outcome if the position is solved without a search
+    unsigned char outcome = DFPN_UNKNOWN;
+
+    // A position seen for the first time is solved straight away if the side to move has a VCF
+    if ( !seen ) {
+
+        vcf_limits vcf;
+        vcf_result line;
+
+        vcf.max_depth = VCF_DEFAULT_DEPTH;
+        vcf.max_nodes = DFPN_VCF_NODES;
+        vcf.table = NULL;
+
+        if ( vcf_search( g, &vcf, &line ) ) {
+            outcome = g->stone == table->attacker ? DFPN_PROVEN : DFPN_DISPROVEN;
+        }
+    }
+
+    // Storing the moves
+    dfpn_child children[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int count = outcome == DFPN_UNKNOWN ? dfpn_children( g, table->attacker, children, &outcome ) : INITIALIZE;
+
+    // Out of memory, the search stops with the numbers it has
+    if ( count < INITIALIZE ) {
+        worker->stopped = true;
+        return;
+    }
+
+    if ( count == INITIALIZE ) {
+        *pn = outcome == DFPN_PROVEN ? INITIALIZE : DFPN_INFINITY;
+        *dn = outcome == DFPN_PROVEN ? DFPN_INFINITY : INITIALIZE;
+        dfpn_store( table, key, *pn, *dn, work + 1 );
+        return;
+    }
+
+    // Storing whether the attacker moves here
+    bool or_node = g->stone == table->attacker;
+
+    // Storing the thresholds of the number minimised over the moves and of the number summed
+    uint32_t th_min = or_node ? th_pn : th_dn;
+    uint32_t th_sum = or_node ? th_dn : th_pn;
+
+    dfpn_visit( table, key, true );
+
+    while ( true ) {
+
+        // Storing the smallest minimised number and the sum of the summed ones
+        uint32_t min = DFPN_INFINITY;
+        uint32_t sum = INITIALIZE;
+
+        // Storing the move picked, its numbers, and the smallest other minimised number, both with their virtual loss
+        int best = -1;
+        uint32_t best_min = DFPN_INFINITY;
+        uint32_t best_sum = INITIALIZE;
+        uint32_t best_seen = DFPN_INFINITY;
+        uint32_t second = DFPN_INFINITY;
+
+        for ( int i = INITIALIZE; i < count; i++ ) {
+
+            // Storing the numbers of the move and the threads searching it
+            uint32_t child_pn = children[i].outcome == DFPN_PROVEN ? INITIALIZE : DFPN_INFINITY;
+            uint32_t child_dn = children[i].outcome == DFPN_PROVEN ? DFPN_INFINITY : INITIALIZE;
+            uint16_t searchers = INITIALIZE;
+
+            if ( children[i].outcome == DFPN_UNKNOWN ) {
+                dfpn_probe( table, children[i].key, &child_pn, &child_dn, NULL, &searchers );
+            }
+
+            // Storing the numbers as minimised and summed here, and the minimised one as this thread sees it
+            uint32_t child_min = or_node ? child_pn : child_dn;
+            uint32_t child_sum = or_node ? child_dn : child_pn;
+            uint32_t child_seen = dfpn_virtual( child_min, searchers );
+
+            min = child_min < min ? child_min : min;
+            sum = dfpn_add( sum, child_sum );
+
+            // Only a move below the threshold can be searched
+            if ( child_min < th_min && child_seen < best_seen ) {
+                second = best_seen < second ? best_seen : second;
+                best = i;
+                best_min = child_min;
+                best_sum = child_sum;
+                best_seen = child_seen;
+            } else if ( child_seen < second ) {
+                second = child_seen;
+            }
+        }
+
+        *pn = or_node ? min : sum;
+        *dn = or_node ? sum : min;
+
+        if ( min >= th_min || sum >= th_sum || worker->stopped ) {
+            break;
+        }
+
+        // Storing the thresholds of the move, which always let it be searched
+        uint32_t next_min = second < th_min ? second + 1 : th_min;
+        uint32_t next_sum = th_sum >= DFPN_INFINITY ? DFPN_INFINITY : th_sum - sum + best_sum;
+
+        if ( next_min <= best_min ) {
+            next_min = best_min + 1;
+        }
+
+        // Storing the numbers the move comes back with, read from the table on the next pass
+        uint32_t child_pn;
+        uint32_t child_dn;
+
+        if ( !game_place_stone( g, children[best].x, children[best].y ) ) {
+            worker->stopped = true;
+            break;
+        }
+        dfpn_mid( worker, g, or_node ? next_min : next_sum, or_node ? next_sum : next_min, &child_pn, &child_dn );
+        game_unplace_stone( g );
+    }
+
+    dfpn_visit( table, key, false );
+    dfpn_store( table, key, *pn, *dn, work + worker->nodes - start );
+}
+
+/**
+ * This function makes a copy of game g for a thread: a new game with the same moves played again, and no journal.
+ * If memory runs out, return NULL instead.
+ * @param g A pointer to the game struct.
+ * @return game* A pointer to the newly created copy, or NULL.
+ */
+static game* dfpn_game_copy( game* g )
+{
+    game* Copy = game_create( g->board->size, g->type );
+
+    if ( !Copy ) {
+        return NULL;
+    }
+
+    for ( size_t i = INITIALIZE; i < g->moves_count; i++ ) {
+        if ( !game_place_stone( Copy, g->moves[i].x, g->moves[i].y ) ) {
+            game_delete( Copy );
+            return NULL;
+        }
+    }
+
+    return Copy;
+}
+
+/**
+ * The body of every thread of a solve: searches the root of its game until it is settled or the solve stops,
+ * then reports its nodes and stops the other threads.
+ * @param arg A pointer to the dfpn_worker.
+ * @return void* NULL.
+ */
+static void* dfpn_run( void* arg )
+{
+    dfpn_worker* worker = ( dfpn_worker* ) arg;
+
+    // Storing the numbers of the root
+    uint32_t pn;
+    uint32_t dn;
+
+    dfpn_mid( worker, worker->game, DFPN_INFINITY, DFPN_INFINITY, &pn, &dn );
+
+    pthread_mutex_lock( &worker->context->lock );
+    worker->context->nodes += worker->pending;
+    worker->pending = INITIALIZE;
+    worker->context->stopped = true;
+    pthread_mutex_unlock( &worker->context->lock );
+
+    return NULL;
+}
+
+/**
+ * This function gives table t of buckets buckets its searcher counts and its locks.
+ * @param t A pointer to the table.
+ * @param buckets The number of buckets.
+ * @return bool false if memory runs out.
+ */
+static bool dfpn_table_share( dfpn_table* t, size_t buckets )
+{
+    t->searchers = ( uint16_t* ) calloc( buckets, sizeof( uint16_t ) );
+
+    if ( !t->searchers ) {
+        return false;
+    }
+
+    for ( int i = INITIALIZE; i < DFPN_LOCK_STRIPES; i++ ) {
+        pthread_mutex_init( &t->locks[i], NULL );
+    }
+
+    return true;
+}
+
+dfpn_table* dfpn_table_create( game* g, size_t megabytes )
+{
+    // Storing the number of buckets, the largest power of two that fits
+    size_t buckets = 1;
+
+    while ( buckets * 2 * DFPN_BUCKET_ENTRIES * sizeof( dfpn_entry ) <= megabytes * 1024 * 1024 ) {
+        buckets *= 2;
+    }
+
+    // Create the dynamically allocated table
+    dfpn_table* Table = ( dfpn_table* ) malloc( sizeof( dfpn_table ) );
+
+    if ( !Table ) {
+        return NULL;
+    }
+
+    Table->entries = ( dfpn_entry* ) calloc( buckets * DFPN_BUCKET_ENTRIES, sizeof( dfpn_entry ) );
+
+    if ( !Table->entries || !dfpn_table_share( Table, buckets ) ) {
+        free( Table->entries );
+        free( Table );
+        return NULL;
+    }
+
+    Table->mask = buckets - 1;
+    Table->size = g->board->size;
+    Table->type = g->type;
+    Table->attacker = g->stone;
+
+    return Table;
+}
+
+unsigned char dfpn_table_delete( dfpn_table* t )
+{
+    if ( !t ) {
+        return NULL_POINTER_ERR;
+    }
+
+    for ( int i = INITIALIZE; i < DFPN_LOCK_STRIPES; i++ ) {
+        pthread_mutex_destroy( &t->locks[i] );
+    }
+
+    free( t->searchers );
+    free( t->entries );
+    free( t );
+
+    return SUCCESS;
+}
+
+unsigned char dfpn_table_save( dfpn_table* t, const char* path )
+{
+    // Storing the path of the temporary file the checkpoint is built in
+    char* temp = malloc( strlen( path ) + strlen( DFPN_CHECKPOINT_SUFFIX ) + 1 );
+
+    if ( !temp ) {
+        return FILE_OUTPUT_ERR;
+    }
+
+    sprintf( temp, "%s" DFPN_CHECKPOINT_SUFFIX, path );
+
+    // Storing the header
+    unsigned char header[DFPN_CHECKPOINT_HEADER_SIZE] = { INITIALIZE };
+    uint64_t buckets = t->mask + 1;
+
+    memcpy( header, DFPN_CHECKPOINT_MAGIC, strlen( DFPN_CHECKPOINT_MAGIC ) );
+    header[2] = DFPN_CHECKPOINT_VERSION;
+    header[3] = t->size;
+    header[4] = t->type;
+    header[5] = t->attacker;
+    for ( int i = INITIALIZE; i < 8; i++ ) {
+        header[8 + i] = ( buckets >> ( 8 * i ) ) & 0xFF;
+    }
+
+    FILE* fp = fopen( temp, "wb" );
+
+    // The entries are written whole, no thread may be halfway through one
+    for ( int i = INITIALIZE; i < DFPN_LOCK_STRIPES; i++ ) {
+        pthread_mutex_lock( &t->locks[i] );
+    }
+
+    // Storing whether the checkpoint is in place
+    bool written = fp && fwrite( header, 1, DFPN_CHECKPOINT_HEADER_SIZE, fp ) == DFPN_CHECKPOINT_HEADER_SIZE &&
+                   fwrite( t->entries, sizeof( dfpn_entry ), buckets * DFPN_BUCKET_ENTRIES, fp ) == buckets * DFPN_BUCKET_ENTRIES &&
+                   fflush( fp ) == 0;
+
+    for ( int i = DFPN_LOCK_STRIPES - 1; i >= INITIALIZE; i-- ) {
+        pthread_mutex_unlock( &t->locks[i] );
+    }
+
+    written = written && fsync( fileno( fp ) ) == 0;
+
+    if ( fp && fclose( fp ) != 0 ) {
+        written = false;
+    }
+
+    written = written && rename( temp, path ) == 0;
+
+    if ( !written ) {
+        unlink( temp );
+    }
+
+    free( temp );
+
+    return written ? SUCCESS : FILE_OUTPUT_ERR;
+}
+
+unsigned char dfpn_table_load( const char* path, dfpn_table** t )
+{
+    *t = NULL;
+
+    FILE* fp = fopen( path, "rb" );
+
+    if ( !fp ) {
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the header and the number of buckets it gives
+    unsigned char header[DFPN_CHECKPOINT_HEADER_SIZE];
+    uint64_t buckets = INITIALIZE;
+
+    if ( fread( header, 1, DFPN_CHECKPOINT_HEADER_SIZE, fp ) != DFPN_CHECKPOINT_HEADER_SIZE ||
+         memcmp( header, DFPN_CHECKPOINT_MAGIC, strlen( DFPN_CHECKPOINT_MAGIC ) ) != 0 || header[2] != DFPN_CHECKPOINT_VERSION ||
+         ( header[3] != 15 && header[3] != 17 && header[3] != 19 ) || ( header[4] != GAME_FREESTYLE && header[4] != GAME_RENJU ) ||
+         ( header[5] != BLACK_STONE && header[5] != WHITE_STONE ) ) {
+        fclose( fp );
+        return FILE_INPUT_ERR;
+    }
+
+    for ( int i = INITIALIZE; i < 8; i++ ) {
+        buckets |= ( uint64_t ) header[8 + i] << ( 8 * i );
+    }
+
+    // Create the dynamically allocated table
+    dfpn_table* Table = ( dfpn_table* ) malloc( sizeof( dfpn_table ) );
+
+    if ( !Table || buckets == INITIALIZE || ( buckets & ( buckets - 1 ) ) != INITIALIZE || buckets > SIZE_MAX / DFPN_BUCKET_ENTRIES / sizeof( dfpn_entry ) ) {
+        free( Table );
+        fclose( fp );
+        return FILE_INPUT_ERR;
+    }
+
+    Table->entries = ( dfpn_entry* ) malloc( buckets * DFPN_BUCKET_ENTRIES * sizeof( dfpn_entry ) );
+
+    // The entries must fill the rest of the file exactly
+    if ( !Table->entries || fread( Table->entries, sizeof( dfpn_entry ), buckets * DFPN_BUCKET_ENTRIES, fp ) != buckets * DFPN_BUCKET_ENTRIES ||
+         fgetc( fp ) != EOF ) {
+        free( Table->entries );
+        free( Table );
+        fclose( fp );
+        return FILE_INPUT_ERR;
+    }
+
+    fclose( fp );
+
+    if ( !dfpn_table_share( Table, buckets ) ) {
+        free( Table->entries );
+        free( Table );
+        return FILE_INPUT_ERR;
+    }
+
+    Table->mask = buckets - 1;
+    Table->size = header[3];
+    Table->type = header[4];
+    Table->attacker = header[5];
+    *t = Table;
+
+    return SUCCESS;
+}
+
+void dfpn_interrupt( void )
+{
+    __atomic_store_n( &dfpn_interrupted, 1, __ATOMIC_RELAXED );
+}
+
+void dfpn_interrupt_reset( void )
+{
+    __atomic_store_n( &dfpn_interrupted, INITIALIZE, __ATOMIC_RELAXED );
+}
+
+bool dfpn_solve( game* g, dfpn_table* t, const dfpn_limits* limits, dfpn_result* result )
+{
+    if ( g->state != GAME_STATE_PLAYING || t->size != g->board->size || t->type != g->type || t->attacker != g->stone ) {
+        return false;
+    }
+
+    // Storing the number of threads asked for
+    unsigned int threads = limits->threads < 1 ? 1 : limits->threads > DFPN_MAX_THREADS ? DFPN_MAX_THREADS : limits->threads;
+
+    // Storing the bookkeeping of the solve
+    dfpn_context context = { .table = t, .limits = limits, .start = time( NULL ), .saved = time( NULL ),
+                             .nodes = INITIALIZE, .threads = threads, .stopped = false, .status = SUCCESS };
+
+    pthread_mutex_init( &context.lock, NULL );
+
+    // The search plays its moves on g itself, none of them belong in the journal
+    struct journal* journal = g->journal;
+
+    g->journal = NULL;
+
+    // The root is always searched, so the move that wins it is known
+    uint32_t pn;
+    uint32_t dn;
+    uint64_t key = dfpn_key( g );
+
+    if ( !dfpn_probe( t, key, &pn, &dn, NULL, NULL ) ) {
+        dfpn_store( t, key, pn, dn, INITIALIZE );
+    }
+
+    // Storing the threads, the caller being the first, each but the first on its own copy of g
+    dfpn_worker workers[DFPN_MAX_THREADS];
+    pthread_t ids[DFPN_MAX_THREADS];
+    unsigned int started = 1;
+
+    // Storing the stack size of the helper threads, deep searches go past the default on some systems
+    pthread_attr_t attr;
+
+    pthread_attr_init( &attr );
+    pthread_attr_setstacksize( &attr, ( size_t ) DFPN_STACK_MB * 1024 * 1024 );
+
+    for ( unsigned int i = INITIALIZE; i < threads; i++ ) {
+
+        // Storing the thread being set up, a helper that can't get a game or a thread is left out
+        dfpn_worker* worker = &workers[i == INITIALIZE ? INITIALIZE : started];
+
+        worker->context = &context;
+        worker->game = i == INITIALIZE ? g : dfpn_game_copy( g );
+        worker->nodes = INITIALIZE;
+        worker->pending = INITIALIZE;
+        worker->budget = 1;
+        worker->stopped = false;
+
+        if ( i == INITIALIZE ) {
+            continue;
+        }
+        if ( worker->game && pthread_create( &ids[started], &attr, dfpn_run, worker ) == 0 ) {
+            started++;
+        } else if ( worker->game ) {
+            game_delete( worker->game );
+        }
+    }
+
+    pthread_mutex_lock( &context.lock );
+    context.threads = started;
+    pthread_mutex_unlock( &context.lock );
+
+    dfpn_run( &workers[INITIALIZE] );
+
+    for ( unsigned int i = 1; i < started; i++ ) {
+        pthread_join( ids[i], NULL );
+        game_delete( workers[i].game );
+    }
+
+    pthread_attr_destroy( &attr );
+    pthread_mutex_destroy( &context.lock );
+
+    dfpn_probe( t, key, &pn, &dn, NULL, NULL );
+
+    result->outcome = pn == INITIALIZE ? DFPN_PROVEN : dn == INITIALIZE ? DFPN_DISPROVEN : DFPN_UNKNOWN;
+    result->pn = pn;
+    result->dn = dn;
+    result->nodes = context.nodes;
+    result->x = BOARD_MAX_SIZE;
+    result->y = BOARD_MAX_SIZE;
+
+    // Storing the moves of the root, to pick the one with the smallest proof number
+    dfpn_child children[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    unsigned char outcome;
+    int count = dfpn_children( g, t->attacker, children, &outcome );
+
+    // Storing the smallest proof number so far
+    uint32_t best = DFPN_INFINITY;
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+
+        // Storing the numbers of the move
+        uint32_t child_pn = children[i].outcome == DFPN_PROVEN ? INITIALIZE : DFPN_INFINITY;
+        uint32_t child_dn;
+
+        if ( children[i].outcome == DFPN_UNKNOWN ) {
+            dfpn_probe( t, children[i].key, &child_pn, &child_dn, NULL, NULL );
+        }
+        if ( child_pn < best || i == INITIALIZE ) {
+            best = child_pn;
+            result->x = children[i].x;
+            result->y = children[i].y;
+        }
+    }
+
+    // A five point wins without any move to search
+    unsigned char points[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+
+    if ( count == INITIALIZE && vcf_fives( g, g->stone, points ) > INITIALIZE ) {
+        result->x = points[INITIALIZE];
+        result->y = points[1];
+    }
+
+    g->journal = journal;
+
+    if ( limits->checkpoint ) {
+        context.status = dfpn_table_save( t, limits->checkpoint );
+    }
+    result->status = context.status;
+
+    return true;
+}
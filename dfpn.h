@@ -0,0 +1,169 @@
+#ifndef _DFPN_H_
+#define _DFPN_H_
+#include "game.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#define DFPN_INFINITY 0x7FFFFFFFU
+#define DFPN_DEFAULT_MB 256
+#define DFPN_BUCKET_ENTRIES 4
+#define DFPN_NEIGHBOURHOOD 2
+#define DFPN_VCF_NODES 200
+#define DFPN_CLOCK_INTERVAL 1024
+#define DFPN_DEFAULT_CHECKPOINT_SECONDS 600
+#define DFPN_MAX_THREADS 64
+#define DFPN_LOCK_STRIPES 1024
+#define DFPN_VIRTUAL_SHARE 4
+#define DFPN_STACK_MB 16
+#define DFPN_KEY 0x510E527FADE682D1ULL
+#define DFPN_UNKNOWN 0
+#define DFPN_PROVEN 1
+#define DFPN_DISPROVEN 2
+#define DFPN_CHECKPOINT_MAGIC "GD"
+#define DFPN_CHECKPOINT_VERSION 1
+#define DFPN_CHECKPOINT_HEADER_SIZE 16
+#define DFPN_CHECKPOINT_SUFFIX ".tmp"
+
+/*
+ * Checkpoint (version 1) layout:
+ *   0  "GD"          magic
+ *   2  version       DFPN_CHECKPOINT_VERSION
+ *   3  size          15, 17 or 19
+ *   4  type          GAME_FREESTYLE or GAME_RENJU
+ *   5  attacker      BLACK_STONE or WHITE_STONE, the side the numbers are for
+ *   6  reserved      0, 0
+ *   8  buckets       64-bit little-endian number of buckets, a power of two
+ *  16  entries       buckets * DFPN_BUCKET_ENTRIES dfpn_entry structs as laid out in memory
+ * The entries are written in the byte order of the machine, a checkpoint is meant to be resumed where it was written.
+ */
+
+/**
+ * The proof and disproof numbers of one position, for a win of the table's attacker. key is the position key, 0 for an empty entry,
+ * pn and dn are the numbers, 0 and DFPN_INFINITY once the position is solved, and work is the number of nodes spent on it,
+ * so the cheapest entry of a bucket is the one replaced.
+ */
+typedef struct {
+    uint64_t key;
+    uint32_t pn;
+    uint32_t dn;
+    uint64_t work;
+} dfpn_entry;
+
+/**
+ * A table of proof and disproof numbers: a power-of-two number of buckets of DFPN_BUCKET_ENTRIES entries, picked by the low bits
+ * of the key. The numbers hold for a win of attacker under the rules of type on a board of size, whatever the starting position,
+ * so a table can be reused for any position of the same game and side.
+ * The threads of a solve share it: bucket i is guarded by locks[i % DFPN_LOCK_STRIPES], and searchers[i] counts the threads
+ * inside a position of bucket i, up to UINT16_MAX, which the others treat as a virtual loss. Neither is saved in a checkpoint.
+ */
+typedef struct {
+    dfpn_entry* entries;
+    uint16_t* searchers;
+    pthread_mutex_t locks[DFPN_LOCK_STRIPES];
+    size_t mask;
+    unsigned char size;
+    unsigned char type;
+    unsigned char attacker;
+} dfpn_table;
+
+/**
+ * The budget of a solve. max_nodes and max_seconds are 0 for no limit, max_nodes counting the nodes of every thread,
+ * which report them every DFPN_CLOCK_INTERVAL nodes at most, so several threads may go a little past it.
+ * If checkpoint isn't NULL, the table is saved to that path every checkpoint_seconds seconds (0 for never) and when the solve ends,
+ * so a stopped solve can be resumed with dfpn_table_load(). threads is the number of threads searching, 0 or 1 for the caller alone,
+ * capped at DFPN_MAX_THREADS.
+ */
+typedef struct {
+    unsigned long max_nodes;
+    unsigned long max_seconds;
+    const char* checkpoint;
+    unsigned long checkpoint_seconds;
+    unsigned int threads;
+} dfpn_limits;
+
+/**
+ * The outcome of a solve. outcome is DFPN_PROVEN if the side to move wins, DFPN_DISPROVEN if it can't force a win
+ * (the opponent wins or the board fills up), DFPN_UNKNOWN if the budget ran out first. x, y is the winning move once proven,
+ * otherwise the most promising one. pn and dn are the numbers of the position, nodes the number of nodes visited,
+ * and status the status of the last checkpoint written, SUCCESS if none was asked for.
+ */
+typedef struct {
+    unsigned char outcome;
+    unsigned char x;
+    unsigned char y;
+    uint32_t pn;
+    uint32_t dn;
+    unsigned long nodes;
+    unsigned char status;
+} dfpn_result;
+
+/**
+ * This function creates an empty table of at most megabytes megabytes, rounded down to a power of two number of buckets
+ * but never less than one bucket, for the positions of game g with the side to move as attacker.
+ * If memory runs out, return NULL instead.
+ * @param g A pointer to the game struct to be solved.
+ * @param megabytes The size of the table in megabytes.
+ * @return dfpn_table* A pointer to the newly created table, or NULL.
+ */
+dfpn_table* dfpn_table_create(game* g, size_t megabytes);
+
+/**
+ * This function frees a table, its entries and its locks.
+ * If t is NULL, return NULL_POINTER_ERR as defined in error-codes.h, otherwise return SUCCESS.
+ * @param t A pointer to the table.
+ * @return unsigned char SUCCESS, or NULL_POINTER_ERR.
+ */
+unsigned char dfpn_table_delete(dfpn_table* t);
+
+/**
+ * This function saves table t to path. It is written to a temporary file that is synced and renamed over path,
+ * so path always holds a whole checkpoint. Every lock of the table is held while the entries are written.
+ * @param t A pointer to the table.
+ * @param path The path of the checkpoint.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if the checkpoint can't be written.
+ */
+unsigned char dfpn_table_save(dfpn_table* t, const char* path);
+
+/**
+ * This function loads the table saved at path by dfpn_table_save() and stores it in t.
+ * @param path The path of the checkpoint.
+ * @param t A pointer to store the newly created table, set to NULL on error.
+ * @return unsigned char SUCCESS, or FILE_INPUT_ERR if the checkpoint can't be read or is invalid.
+ */
+unsigned char dfpn_table_load(const char* path, dfpn_table** t);
+
+/**
+ * This function asks a running dfpn_solve() to stop as soon as it can, saving its checkpoint on the way out.
+ * It only sets a flag, so it may be called from a signal handler. The flag stays set, and any later solve stops at once,
+ * until dfpn_interrupt_reset() clears it.
+ */
+void dfpn_interrupt(void);
+
+/**
+ * This function clears the flag set by dfpn_interrupt(). Call it before installing a handler that calls dfpn_interrupt(),
+ * so a signal that arrives before the solve starts still stops it.
+ */
+void dfpn_interrupt_reset(void);
+
+/**
+ * This function proves or disproves a win for the side to move in game g with depth-first proof-number search,
+ * keeping the proof and disproof numbers of every position in table t, which may hold the numbers of an earlier solve.
+ * Moves are made and taken back with game_place_stone() and game_unplace_stone(), so the Renju bans are judged as in a game.
+ * The side to move wins outright with a five point, and loses outright to two five points of the opponent. It must block a single
+ * five point, and answer threes with the replies of vct_replies(). Otherwise it may play within DFPN_NEIGHBOURHOOD of a stone.
+ * A position is also solved on its first visit if the side to move has a VCF within DFPN_VCF_NODES nodes.
+ * With more than one thread, every helper thread searches a copy of g and all of them share t. Each thread starts from the root
+ * and works its way down to the most proving position no other thread is in: a move looks worse by 1 + number / DFPN_VIRTUAL_SHARE
+ * for every thread already in its position, so idle threads take over the next best lines instead of following the busy ones.
+ * The solve ends for all as soon as one thread settles the root or the budget runs out.
+ * g is left as it was found.
+ * @param g A pointer to the game struct, whose state must be GAME_STATE_PLAYING.
+ * @param t A pointer to the table, made for g's board size, type and side to move.
+ * @param limits A pointer to the budget.
+ * @param result A pointer to store the outcome.
+ * @return bool false if g isn't being played or t was made for another board, rules or side, true otherwise.
+ */
+bool dfpn_solve(game* g, dfpn_table* t, const dfpn_limits* limits, dfpn_result* result);
+#endif
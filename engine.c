@@ -0,0 +1,580 @@
+/**
+* @file engine.c
+* @author Sadia Ahmed (sahmed23)
+* This file implements the computer player, a negamax alpha-beta search
+* with iterative deepening over the moves near the stones on the board
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "engine.h"
+#include "game.h"
+#include "board.h"
+#include "pattern.h"
+#include "rules.h"
+#include "transposition.h"
+#include "vcf.h"
+
+#include <stdbool.h>
+#include <time.h>
+
+// How often, in nodes, the clock is read
+#define ENGINE_CLOCK_INTERVAL 1024
+
+// Bound on static evaluations so they never look like a forced result
+#define ENGINE_EVAL_LIMIT ( ENGINE_WIN / 2 )
+
+// Score of a point for each line pattern it would make, indexed by pattern class
+static const int engine_pattern_score[] = { 0, 500, 800, 10000, 10000, 100000, 0 };
+
+// Score of each own stone near a point
+#define ENGINE_NEIGHBOUR_SCORE 10
+
+/**
+ * The bookkeeping of one search.
+ */
+typedef struct {
+    const engine_limits* limits;
+    struct timespec start;
+    unsigned long nodes;
+    bool can_stop;
+    bool stopped;
+} engine_context;
+
+/**
+ * A candidate move together with what it is worth to the side to move and to the opponent.
+ */
+typedef struct {
+    unsigned char x;
+    unsigned char y;
+    int own;
+    int other;
+} engine_candidate;
+
+/**
+ * This function returns the pattern rule that applies to stone in game g.
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @return unsigned char PATTERN_EXACT_FIVE for black in Renju, PATTERN_FIVE_OR_MORE otherwise.
+ */
+static unsigned char engine_rule( game* g, unsigned char stone )
+{
+    return g->type == GAME_RENJU && stone == BLACK_STONE ? PATTERN_EXACT_FIVE : PATTERN_FIVE_OR_MORE;
+}
+
+/**
+ * This function scores the empty point x, y for the player stone by the line patterns a stone there would make,
+ * plus a little for every own stone close by. A point where the move would be forbidden for black scores 0.
+ * @param g A pointer to the game struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param stone The player's stone type.
+ * @return int The score of the point.
+ */
+static int engine_point_score( game* g, unsigned char x, unsigned char y, unsigned char stone )
+{
+    // Storing the rule of the player
+    unsigned char rule = engine_rule( g, stone );
+
+    // Storing the score and the number of threatening lines
+    int score = INITIALIZE;
+    int threats = INITIALIZE;
+
+    // Storing whether the point makes five or an overline
+    bool five = false;
+    bool overline = false;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+        // Storing the pattern of the line
+        int type = pattern_type( pattern_line( g->board, x, y, direction, stone, rule ) );
+
+        score += engine_pattern_score[type];
+        five = five || type == PATTERN_FIVE;
+        overline = overline || type == PATTERN_OVERLINE;
+        if ( type == PATTERN_DOUBLE_FOUR ) {
+            threats += MAX_VIOLATIONS;
+        } else if ( type != PATTERN_NONE && type != PATTERN_OVERLINE ) {
+            threats++;
+        }
+
+        // Storing the own stones up to ENGINE_NEIGHBOURHOOD away on the line
+        uint32_t line = board_line( g->board, x, y, direction, stone );
+        int pos = board_line_index( direction, x, y );
+        uint32_t near = ( uint32_t ) ( ( ( uint64_t ) line << ENGINE_NEIGHBOURHOOD ) >> pos ) & ( ( 1 << ( 2 * ENGINE_NEIGHBOURHOOD + 1 ) ) - 1 );
+
+        score += __builtin_popcount( near ) * ENGINE_NEIGHBOUR_SCORE;
+    }
+
+    // Only a move that could be a double three, double four or overline needs the full forbidden check
+    if ( rule == PATTERN_EXACT_FIVE && !five && ( overline || threats >= MAX_VIOLATIONS ) && rules_is_forbidden( g->board, x, y ) ) {
+        return INITIALIZE;
+    }
+
+    return score;
+}
+
+/**
+ * This function lists the empty intersections within ENGINE_NEIGHBOURHOOD of a stone, or the center of an empty board,
+ * scoring each for the side to move and for the opponent.
+ * @param g A pointer to the game struct.
+ * @param candidates The buffer to store the candidates, BOARD_MAX_SIZE * BOARD_MAX_SIZE entries.
+ * @return int The number of candidates.
+ */
+static int engine_candidates( game* g, engine_candidate* candidates )
+{
+    // Storing the size of the board and the mask of a full row
+    int size = g->board->size;
+    uint32_t full = ( ( uint32_t ) 1 << size ) - 1;
+
+    // Storing the occupied intersections of each row, and the same spread sideways
+    uint32_t occupied[BOARD_MAX_SIZE];
+    uint32_t spread[BOARD_MAX_SIZE];
+
+    // Storing the number of candidates found
+    int count = INITIALIZE;
+
+    if ( g->board->stones_count == INITIALIZE ) {
+        candidates[count].x = size / 2;
+        candidates[count].y = size / 2;
+        candidates[count].own = INITIALIZE;
+        candidates[count].other = INITIALIZE;
+        return 1;
+    }
+
+    for ( int y = INITIALIZE; y < size; y++ ) {
+        occupied[y] = board_line( g->board, INITIALIZE, y, DIRECTION_HORIZONTAL, BLACK_STONE ) |
+                      board_line( g->board, INITIALIZE, y, DIRECTION_HORIZONTAL, WHITE_STONE );
+        spread[y] = occupied[y];
+        for ( int k = 1; k <= ENGINE_NEIGHBOURHOOD; k++ ) {
+            spread[y] |= ( occupied[y] << k ) | ( occupied[y] >> k );
+        }
+    }
+
+    // Storing the opponent's stone type
+    unsigned char other = g->stone == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    for ( int y = INITIALIZE; y < size; y++ ) {
+
+        // Storing the empty intersections of the row near a stone
+        uint32_t near = INITIALIZE;
+
+        for ( int k = -ENGINE_NEIGHBOURHOOD; k <= ENGINE_NEIGHBOURHOOD; k++ ) {
+            if ( y + k >= INITIALIZE && y + k < size ) {
+                near |= spread[y + k];
+            }
+        }
+        near &= full & ~occupied[y];
+
+        while ( near ) {
+
+            // Storing the column of the lowest bit
+            unsigned char x = __builtin_ctz( near );
+
+            near &= near - 1;
+            candidates[count].x = x;
+            candidates[count].y = y;
+            candidates[count].own = engine_point_score( g, x, y, g->stone );
+            candidates[count].other = engine_point_score( g, x, y, other );
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * This function returns the ordering key of a candidate, attacking points ahead of equal defending points.
+ * @param candidate A pointer to the candidate.
+ * @return int The ordering key.
+ */
+static int engine_order_key( const engine_candidate* candidate )
+{
+    return 2 * candidate->own + candidate->other;
+}
+
+/**
+ * This function sorts the candidates by decreasing ordering key, moving the candidate at first_x, first_y to the front.
+ * @param candidates The candidates.
+ * @param count The number of candidates.
+ * @param first_x The horizontal coordinate of the move to try first, or BOARD_MAX_SIZE for none.
+ * @param first_y The vertical coordinate of the move to try first.
+ */
+static void engine_order( engine_candidate* candidates, int count, unsigned char first_x, unsigned char first_y )
+{
+    for ( int i = 1; i < count; i++ ) {
+
+        // Storing the candidate being inserted
+        engine_candidate current = candidates[i];
+        int key = engine_order_key( &current );
+        int j = i - 1;
+
+        while ( j >= INITIALIZE && engine_order_key( &candidates[j] ) < key ) {
+            candidates[j + 1] = candidates[j];
+            j--;
+        }
+        candidates[j + 1] = current;
+    }
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        if ( candidates[i].x == first_x && candidates[i].y == first_y ) {
+
+            // Storing the candidate being moved to the front
+            engine_candidate first = candidates[i];
+
+            for ( int j = i; j > INITIALIZE; j-- ) {
+                candidates[j] = candidates[j - 1];
+            }
+            candidates[INITIALIZE] = first;
+            break;
+        }
+    }
+}
+
+/**
+ * This function keeps only the forced candidates: the winning point if the side to move has a five point,
+ * otherwise the opponent's five points if there are any, otherwise every candidate.
+ * @param candidates The candidates.
+ * @param count The number of candidates.
+ * @return int The number of candidates kept.
+ */
+static int engine_forced( engine_candidate* candidates, int count )
+{
+    // Storing the number of opponent five points
+    int blocks = INITIALIZE;
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        if ( candidates[i].own >= engine_pattern_score[PATTERN_FIVE] ) {
+            candidates[INITIALIZE] = candidates[i];
+            return 1;
+        }
+    }
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        if ( candidates[i].other >= engine_pattern_score[PATTERN_FIVE] ) {
+            candidates[blocks++] = candidates[i];
+        }
+    }
+
+    return blocks > INITIALIZE ? blocks : count;
+}
+
+/**
+ * This function returns true once the search has used up its node or time budget.
+ * @param context A pointer to the search bookkeeping.
+ * @return bool true if the search must stop.
+ */
+static bool engine_out_of_budget( engine_context* context )
+{
+    if ( !context->can_stop ) {
+        return false;
+    }
+
+    if ( context->limits->max_nodes && context->nodes >= context->limits->max_nodes ) {
+        return true;
+    }
+
+    if ( context->limits->max_seconds <= INITIALIZE || context->nodes % ENGINE_CLOCK_INTERVAL != INITIALIZE ) {
+        return false;
+    }
+
+    // Storing the wall time now, the search may share the process with others
+    struct timespec now;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return ( now.tv_sec - context->start.tv_sec ) + ( now.tv_nsec - context->start.tv_nsec ) / 1e9 >= context->limits->max_seconds;
+}
+
+/**
+ * This function returns the static evaluation of the position for the side to move,
+ * the sum of the candidate scores of the side to move minus those of the opponent.
+ * @param candidates The candidates of the position.
+ * @param count The number of candidates.
+ * @return int The evaluation, within ENGINE_EVAL_LIMIT.
+ */
+static int engine_evaluate( const engine_candidate* candidates, int count )
+{
+    // Storing the running balance
+    long balance = INITIALIZE;
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        balance += candidates[i].own - candidates[i].other;
+    }
+
+    if ( balance > ENGINE_EVAL_LIMIT ) {
+        return ENGINE_EVAL_LIMIT;
+    } else if ( balance < -ENGINE_EVAL_LIMIT ) {
+        return -ENGINE_EVAL_LIMIT;
+    }
+
+    return ( int ) balance;
+}
+
+/**
+ * This function converts a score at ply plies from the root to the form kept in the table,
+ * where a forced win or loss counts its plies from the position rather than from the root.
+ * @param score The score.
+ * @param ply The distance from the root.
+ * @return int The score to store.
+ */
+static int engine_score_to_table( int score, int ply )
+{
+    if ( score >= ENGINE_WIN - ENGINE_MAX_DEPTH * 2 ) {
+        return score + ply;
+    } else if ( score <= -ENGINE_WIN + ENGINE_MAX_DEPTH * 2 ) {
+        return score - ply;
+    }
+    return score;
+}
+
+/**
+ * This function converts a score read from the table back to a score at ply plies from the root.
+ * @param score The stored score.
+ * @param ply The distance from the root.
+ * @return int The score.
+ */
+static int engine_score_from_table( int score, int ply )
+{
+    if ( score >= ENGINE_WIN - ENGINE_MAX_DEPTH * 2 ) {
+        return score - ply;
+    } else if ( score <= -ENGINE_WIN + ENGINE_MAX_DEPTH * 2 ) {
+        return score + ply;
+    }
+    return score;
+}
+
+/**
+ * This function searches the position of game g depth plies deep and returns its score for the side to move.
+ * @param context A pointer to the search bookkeeping.
+ * @param g A pointer to the game struct.
+ * @param depth The remaining depth.
+ * @param alpha The lower bound of the window.
+ * @param beta The upper bound of the window.
+ * @param ply The distance from the root.
+ * @return int The score of the position, meaningless if context->stopped is set.
+ */
+static int engine_negamax( engine_context* context, game* g, int depth, int alpha, int beta, int ply )
+{
+    context->nodes++;
+
+    if ( g->state != GAME_STATE_PLAYING ) {
+        if ( g->winner == EMPTY_INTERSECTION ) {
+            return INITIALIZE;
+        }
+        return g->winner == g->stone ? ENGINE_WIN - ply : -ENGINE_WIN + ply;
+    }
+
+    if ( engine_out_of_budget( context ) ) {
+        context->stopped = true;
+        return INITIALIZE;
+    }
+
+    // Storing the cached result of the position, if any, looked up before the moves are generated
+    transposition* table = context->limits->table;
+    uint64_t key = table && depth > INITIALIZE ? transposition_key( g ) : INITIALIZE;
+    transposition_entry entry = { INITIALIZE, INITIALIZE, BOARD_MAX_SIZE, BOARD_MAX_SIZE, INITIALIZE, INITIALIZE };
+
+    if ( table && depth > INITIALIZE && transposition_probe( table, key, &entry ) && entry.depth >= depth ) {
+
+        // Storing the cached score as seen from this ply
+        int cached = engine_score_from_table( entry.score, ply );
+        unsigned char bound = entry.info & TRANSPOSITION_BOUND_MASK;
+
+        if ( bound == TRANSPOSITION_EXACT || ( bound == TRANSPOSITION_LOWER && cached >= beta ) ||
+             ( bound == TRANSPOSITION_UPPER && cached <= alpha ) ) {
+            return cached;
+        }
+    }
+
+    // Storing the moves of this node
+    engine_candidate candidates[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int count = engine_candidates( g, candidates );
+
+    if ( count == INITIALIZE ) {
+        return INITIALIZE;
+    }
+
+    count = engine_forced( candidates, count );
+
+    // A five point for the side to move wins on the next move
+    if ( candidates[INITIALIZE].own >= engine_pattern_score[PATTERN_FIVE] ) {
+        return ENGINE_WIN - ply - 1;
+    }
+
+    if ( depth <= INITIALIZE ) {
+        return engine_evaluate( candidates, count );
+    }
+
+    engine_order( candidates, count, entry.x, entry.y );
+
+    // Storing the window the node was searched with and the best score and move so far
+    int alpha_start = alpha;
+    int best = -ENGINE_WIN - 1;
+    unsigned char best_x = BOARD_MAX_SIZE;
+    unsigned char best_y = BOARD_MAX_SIZE;
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+
+        // A move that can't be stored stops the search, nothing was placed to take back
+        if ( !game_place_stone( g, candidates[i].x, candidates[i].y ) ) {
+            context->stopped = true;
+            return INITIALIZE;
+        }
+        int score = -engine_negamax( context, g, depth - 1, -beta, -alpha, ply + 1 );
+        game_unplace_stone( g );
+
+        if ( context->stopped ) {
+            return INITIALIZE;
+        }
+
+        if ( score > best ) {
+            best = score;
+            best_x = candidates[i].x;
+            best_y = candidates[i].y;
+        }
+        if ( score > alpha ) {
+            alpha = score;
+        }
+        if ( alpha >= beta ) {
+            break;
+        }
+    }
+
+    if ( table ) {
+        transposition_store( table, key, depth, best <= alpha_start ? TRANSPOSITION_UPPER : best >= beta ? TRANSPOSITION_LOWER : TRANSPOSITION_EXACT,
+                             engine_score_to_table( best, ply ), best_x, best_y );
+    }
+
+    return best;
+}
+
+
+void engine_default_limits( engine_limits* limits )
+{
+    limits->max_depth = ENGINE_DEFAULT_DEPTH;
+    limits->max_nodes = ENGINE_DEFAULT_NODES;
+    limits->max_seconds = INITIALIZE;
+    limits->table = transposition_local( );
+}
+
+
+bool engine_search( game* g, const engine_limits* limits, engine_result* result )
+{
+    if ( g->state != GAME_STATE_PLAYING ) {
+        return false;
+    }
+
+    // Storing the root moves
+    engine_candidate candidates[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int count = engine_candidates( g, candidates );
+
+    if ( count == INITIALIZE ) {
+        return false;
+    }
+
+    count = engine_forced( candidates, count );
+
+    // Storing the bookkeeping of the search
+    engine_context context = { .limits = limits, .nodes = INITIALIZE, .can_stop = false, .stopped = false };
+
+    clock_gettime( CLOCK_MONOTONIC, &context.start );
+
+    // Storing the deepest depth allowed
+    int max_depth = limits->max_depth > INITIALIZE && limits->max_depth < ENGINE_MAX_DEPTH ? limits->max_depth : ENGINE_MAX_DEPTH;
+
+    result->x = candidates[INITIALIZE].x;
+    result->y = candidates[INITIALIZE].y;
+    result->score = INITIALIZE;
+    result->depth = INITIALIZE;
+
+    // A best move cached by an earlier search is tried first from the first iteration on
+    transposition_entry entry;
+
+    if ( limits->table && transposition_probe( limits->table, transposition_key( g ), &entry ) && entry.x < BOARD_MAX_SIZE ) {
+        result->x = entry.x;
+        result->y = entry.y;
+    }
+
+    if ( limits->table ) {
+        transposition_new_search( limits->table );
+    }
+
+    // A win by continuous fours needs no search, unless the move is forced anyway
+    vcf_limits vcf;
+    vcf_result line;
+
+    vcf_default_limits( &vcf );
+    vcf.table = limits->table;
+
+    if ( count > 1 ) {
+        if ( vcf_search( g, &vcf, &line ) ) {
+            result->x = line.sequence[INITIALIZE].x;
+            result->y = line.sequence[INITIALIZE].y;
+            result->score = ENGINE_WIN - line.length;
+            result->depth = line.length;
+            result->nodes = line.nodes;
+            return true;
+        }
+        context.nodes = line.nodes;
+    }
+
+    // The search plays its moves on g itself, none of them belong in the journal
+    struct journal* journal = g->journal;
+
+    g->journal = NULL;
+
+    for ( int depth = 1; depth <= max_depth; depth++ ) {
+
+        engine_order( candidates, count, result->x, result->y );
+
+        // Storing the best move of this iteration
+        int best = -ENGINE_WIN - 1;
+        unsigned char best_x = candidates[INITIALIZE].x;
+        unsigned char best_y = candidates[INITIALIZE].y;
+        int alpha = -ENGINE_WIN - 1;
+
+        for ( int i = INITIALIZE; i < count; i++ ) {
+
+            if ( !game_place_stone( g, candidates[i].x, candidates[i].y ) ) {
+                context.stopped = true;
+                break;
+            }
+            int score = -engine_negamax( &context, g, depth - 1, -ENGINE_WIN - 1, -alpha, 1 );
+            game_unplace_stone( g );
+
+            if ( context.stopped ) {
+                break;
+            }
+
+            if ( score > best ) {
+                best = score;
+                best_x = candidates[i].x;
+                best_y = candidates[i].y;
+            }
+            if ( score > alpha ) {
+                alpha = score;
+            }
+        }
+
+        if ( context.stopped ) {
+            break;
+        }
+
+        result->x = best_x;
+        result->y = best_y;
+        result->score = best;
+        result->depth = depth;
+        context.can_stop = true;
+
+        // A proven result won't change with more depth
+        if ( best >= ENGINE_WIN - ENGINE_MAX_DEPTH || best <= -ENGINE_WIN + ENGINE_MAX_DEPTH || count == 1 ) {
+            break;
+        }
+    }
+
+    g->journal = journal;
+    result->nodes = context.nodes;
+
+    return true;
+}
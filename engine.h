@@ -0,0 +1,61 @@
+#ifndef _ENGINE_H_
+#define _ENGINE_H_
+#include "game.h"
+#include "transposition.h"
+#include <stdbool.h>
+
+#define ENGINE_MAX_DEPTH 64
+#define ENGINE_DEFAULT_DEPTH 8
+#define ENGINE_DEFAULT_NODES 50000
+#define ENGINE_WIN 1000000
+#define ENGINE_NEIGHBOURHOOD 2
+
+/**
+ * The budget of a search. Zero means no limit for max_nodes and max_seconds, max_seconds counting wall time from the start
+ * of the search; max_depth is capped at ENGINE_MAX_DEPTH.
+ * table is the transposition table the search reads and fills, or NULL to search without one.
+ */
+typedef struct {
+    unsigned char max_depth;
+    unsigned long max_nodes;
+    double max_seconds;
+    transposition* table;
+} engine_limits;
+
+/**
+ * The outcome of a search: the best move found, its score from the point of view of the side to move
+ * (ENGINE_WIN minus the number of plies to the win for a forced win), the deepest fully searched depth,
+ * and the number of nodes visited.
+ */
+typedef struct {
+    unsigned char x;
+    unsigned char y;
+    int score;
+    unsigned char depth;
+    unsigned long nodes;
+} engine_result;
+
+/**
+ * This function fills limits with the default budget, ENGINE_DEFAULT_DEPTH plies and ENGINE_DEFAULT_NODES nodes,
+ * searched with the calling thread's table from transposition_local().
+ * @param limits A pointer to the limits struct to fill.
+ */
+void engine_default_limits(engine_limits* limits);
+
+/**
+ * This function searches the position of game g for the side to move with negamax alpha-beta and iterative deepening,
+ * and stores the best move of the last completed iteration in result.
+ * Moves are only generated within ENGINE_NEIGHBOURHOOD intersections of a stone, and are made and taken back with
+ * game_place_stone() and game_unplace_stone(), so black's forbidden moves in Renju lose exactly as they do in a game.
+ * The first iteration always completes; later ones stop as soon as the node or time budget runs out.
+ * A win by continuous fours found by vcf_search() within its default budget is played without searching further.
+ * Positions reached again through another move order are looked up in limits->table: a deep enough result cuts the node short,
+ * and the best move stored is tried first. Forced wins are stored relative to the position, so they stay valid at any ply.
+ * g is left as it was found.
+ * @param g A pointer to the game struct, whose state must be GAME_STATE_PLAYING.
+ * @param limits A pointer to the search budget.
+ * @param result A pointer to store the outcome of the search.
+ * @return bool true if a move was found, false if the game is over or the board is full.
+ */
+bool engine_search(game* g, const engine_limits* limits, engine_result* result);
+#endif
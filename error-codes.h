@@ -10,4 +10,5 @@
 #define FILE_INPUT_ERR 8
 #define RESUME_ERR 9
 #define ARGUMENT_ERR 10
+#define MEMORY_ERR 11
 #endif
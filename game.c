@@ -10,6 +10,9 @@
 #include "io.h"
 #include "board.h"
 #include "game.h"
+#include "rules.h"
+#include "engine.h"
+#include "journal.h"
 #include "error-codes.h"
 
 #include <string.h>
@@ -21,26 +24,87 @@ game* game_create( unsigned char board_size, unsigned char game_type )
 {
 
     game * Game = ( game * ) malloc ( sizeof( game ) );
+
+    if ( !Game ) {
+        return NULL;
+    }
+
     Game->board = board_create( board_size );
     Game->type = game_type;
     Game->stone = BLACK_STONE;
     Game->state = GAME_STATE_PLAYING;
     Game->winner = EMPTY_INTERSECTION;
+    Game->computer = EMPTY_INTERSECTION;
+    Game->journal = NULL;
     Game->moves_capacity = GAME_CAPACITY;
     Game->moves = ( move * ) malloc( Game->moves_capacity * sizeof( move ) );
     Game->moves_count = INITIALIZE;
+
+    if ( !Game->board || !Game->moves ) {
+        game_delete( Game );
+        return NULL;
+    }
+
     return Game;
 
 }
 
-void game_delete( game* g )
+unsigned char game_delete( game* g )
 {
     if ( !g ) {
-        exit ( NULL_POINTER_ERR );
+        return NULL_POINTER_ERR;
     }
 
+    if ( g->board ) {
+        board_delete( g->board );
+    }
+    if ( g->journal ) {
+        journal_close( g->journal );
+    }
     free( g->moves );
     free( g );
+
+    return SUCCESS;
+}
+
+/**
+ * Returns true if the line input read from the terminal is exactly command, up to the whitespace after it.
+ * @param input The line.
+ * @param command The command.
+ * @return bool true if input is command.
+ */
+static bool game_command( const char* input, const char* command )
+{
+    // Storing the length of the command
+    size_t length = strlen( command );
+
+    return strncmp( input, command, length ) == INITIALIZE && input[length + strspn( input + length, " \t\r\n" )] == '\0';
+}
+
+/**
+ * Takes back the last move of g, and in a game against the computer also the computer's moves after the player's last one,
+ * so it is the player's turn again.
+ * @param g A pointer to the game struct.
+ * @return bool false if there is no move of the player to take back.
+ */
+static bool game_undo( game* g )
+{
+    // Storing the number of moves to take back
+    size_t undo = 1;
+
+    while ( undo <= g->moves_count && ( g->computer & g->moves[g->moves_count - undo].stone ) ) {
+        undo++;
+    }
+
+    if ( undo > g->moves_count ) {
+        return false;
+    }
+
+    for ( size_t i = INITIALIZE; i < undo; i++ ) {
+        game_unplace_stone( g );
+    }
+
+    return true;
 }
 
 bool game_update( game* g ) 
@@ -58,6 +122,23 @@ bool game_update( game* g )
     // Creating y to store the horizontal coord
     unsigned char y;
 
+    if ( g->computer & g->stone ) {
+
+        // Storing the budget and outcome of the search
+        engine_limits limits;
+        engine_result result;
+
+        engine_default_limits( &limits );
+        if ( !engine_search( g, &limits, &result ) ) {
+            return false;
+        }
+
+        board_formal_coord( g->board, result.x, result.y, input );
+        printf( "%s stone's turn, the computer plays %s.\n", g->stone == BLACK_STONE ? "Black" : "White", input );
+
+        return game_place_stone( g, result.x, result.y );
+    }
+
     while ( true ) {
         printf( "%s stone's turn, please enter a move: \n", g->stone == BLACK_STONE ? "Black" : "White" );
 
@@ -74,8 +155,18 @@ bool game_update( game* g )
             return false;
         }
 
+        if ( game_command( input, UNDO_COMMAND ) ) {
+            if ( game_undo( g ) ) {
+                return true;
+            }
+            printf( "There is no move to undo, please enter a move.\n" );
+            continue;
+        }
+
         if ( board_coord( g->board, input, &x, &y ) == SUCCESS ) {
-            if ( game_place_stone( g, x, y ) ) {
+            if ( board_get( g->board, x, y ) != EMPTY_INTERSECTION ) {
+                printf( "There is already a stone at the coordinate you entered, please try again.\n" );
+            } else if ( game_place_stone( g, x, y ) ) {
                 return true;
             }
         }
@@ -86,8 +177,13 @@ bool game_update( game* g )
 
 void game_loop( game* g )
 {
+    // Storing what the terminal shows of the board
+    board_view view;
+
+    board_view_init( &view );
+
     do {
-        board_print( g->board, true );
+        board_view_print( &view, g->board );
         if ( g->state != GAME_STATE_PLAYING ) {
             break;
         }
@@ -102,26 +198,97 @@ void game_loop( game* g )
     }
 }
 
-void game_resume( game* g ) 
+unsigned char game_resume( game* g ) 
 {
     if ( g->state != GAME_STATE_STOPPED ) {
-        exit( RESUME_ERR );
+        return RESUME_ERR;
+    }
+
+    // Imports leave the board empty, the position is set up from the moves
+    for ( size_t i = INITIALIZE; i < g->moves_count; i++ ) {
+        board_set( g->board, g->moves[i].x, g->moves[i].y, g->moves[i].stone );
+    }
+    if ( g->moves_count > INITIALIZE ) {
+        g->stone = g->moves[g->moves_count - 1].stone == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
     }
 
     g->state = GAME_STATE_PLAYING;
 
     game_loop( g );
+
+    return SUCCESS;
 }
 
 
 
+/**
+ * Appends the moves list entry of move i of g to list, as game_replay() prints it.
+ * @param g A pointer to the game struct.
+ * @param i The index of the move.
+ * @param list The buffer to append to, with room for REPLAY_ENTRY_LENGTH more bytes.
+ * @return size_t The length of the entry.
+ */
+static size_t game_replay_entry( game* g, size_t i, char* list )
+{
+    // Storing the label of the side that played move i
+    const char* label = g->moves[i].stone == BLACK_STONE ? "Black: " : "  White: ";
+
+    // Creating a string to store the formatted coord, right-aligned in BOARD_COORD_LENGTH columns
+    char formatted_coord[BOARD_COORD_LENGTH];
+    size_t coord_length = board_format_coord( g->moves[i].x, g->moves[i].y, formatted_coord );
+
+    // Storing the length of the entry so far
+    size_t length = strlen( label );
+
+    memcpy( list, label, length );
+    memset( list + length, ' ', BOARD_COORD_LENGTH - coord_length );
+    length += BOARD_COORD_LENGTH - coord_length;
+    memcpy( list + length, formatted_coord, coord_length );
+    length += coord_length;
+
+    if ( g->moves[i].stone != BLACK_STONE ) {
+        list[length++] = '\n';
+    }
+
+    return length;
+}
+
+/**
+ * Prints how game g concluded, as game_replay() does after its last move.
+ * @param g A pointer to the game struct.
+ */
+static void game_replay_conclusion( game* g )
+{
+    if ( g->state == GAME_STATE_FINISHED && g->winner != EMPTY_INTERSECTION ) {
+        printf( "Game concluded, %s won.\n", g->stone == BLACK_STONE ? "white" : "black" );
+    } else if ( g->state == GAME_STATE_FORBIDDEN ) {
+        printf( "Game concluded, black made a forbidden move, white won.\n" );
+    } else if ( g->state == GAME_STATE_FINISHED && g->winner == EMPTY_INTERSECTION ) {
+        printf( "Game concluded, the board is full, draw.\n" );
+    } else {
+        printf( "The game is stopped.\n" );
+    }
+}
+
 void game_replay( game* g ) 
 {
 
-    // Creating a string to store the formatted coord
-    char formatted_coord[DEFAULT_STRING_LENGTH];
+    // Storing what the terminal shows of the board
+    board_view view;
+
+    // Storing the moves list formatted so far, one entry appended per move
+    char* moves_list = malloc( g->moves_count * REPLAY_ENTRY_LENGTH + 1 );
+
+    // Storing the length of the formatted moves list
+    size_t moves_length = INITIALIZE;
+
+    if ( !moves_list ) {
+        return;
+    }
+
+    board_view_init( &view );
 
-    for ( int i = INITIALIZE; i < g->moves_count; i++ ) {
+    for ( size_t i = INITIALIZE; i < g->moves_count; i++ ) {
 
         // Storing the x coord of current i
         unsigned char x = g->moves[i].x;
@@ -134,1701 +301,455 @@ void game_replay( game* g )
 
         board_set( g->board, x, y, stone );
 
-        board_print( g->board, true );
-
-        if ( i == g->moves_count - 1 ) {
+        moves_length += game_replay_entry( g, i, moves_list + moves_length );
 
-            if ( g->state == GAME_STATE_FINISHED && g->winner != EMPTY_INTERSECTION ) {
-                printf( "Game concluded, %s won.\n", g->stone == BLACK_STONE ? "white" : "black" );
-            } else if ( g->state == GAME_STATE_FORBIDDEN ) {
-                printf( "Game concluded, black made a forbidden move, white won.\n" );
-            } else if ( g->state == GAME_STATE_FINISHED && g->winner == EMPTY_INTERSECTION ) {
-                printf( "Game concluded, the board is full, draw.\n" );
-            } else {
-                printf( "The game is stopped.\n" );
-            }
+        board_view_print( &view, g->board );
 
+        if ( i == g->moves_count - 1 ) {
+            game_replay_conclusion( g );
         }
 
         printf( "Moves:\n" );
-
-        for ( int j = INITIALIZE; j <= i; j++ ) {
-            board_formal_coord( g->board, g->moves[j].x, g->moves[j].y, formatted_coord );
-            if ( g->moves[j].stone == BLACK_STONE ) {
-                printf( "Black: %3s", formatted_coord );
-            } else {
-                printf( "  White: %3s\n", formatted_coord );
-            }
-        }
+        fwrite( moves_list, 1, moves_length, stdout );
 
         // sleep( 1 ); // Pause for 1 second before next move
     }
 
-    if ( g->moves[g->moves_count - 1].stone != WHITE_STONE ) {
+    if ( g->moves_count > INITIALIZE && g->moves[g->moves_count - 1].stone != WHITE_STONE ) {
         printf( "\n" );
     }
 
+    free( moves_list );
 
 }
 
-
-/**
- * This function checks for winning conditions in freestyle Gomoku.
- * If five or more consecutive stones are found in any direction (horizontal, vertical, main diagonals, secondary diagonals), 
- * it updates the game state and winner and returns true. If the board is full, it updates the game state to finished and returns false. Otherwise, returns true.
- * @param g A pointer to the game struct.
- * @param x The x-coordinate of the last move.
- * @param y The y-coordinate of the last move.
- * @return bool true if the game continues or is won, false if it stops.
- */
-static bool game_freestyle_gomoku( game* g, unsigned char x, unsigned char y ) {
-
-    // Casting the board grid
-    unsigned char ( *grid )[g->board->size] = ( unsigned char ( * )[g->board->size] ) g->board->grid;
-
-    // Storing the size of the board
-    int size = g->board->size;
-
-    // Creating a counter for stones
-    int count;
-
-    // Check horizontal
-    for ( int i = INITIALIZE; i < size; i++ ) {
-        count = INITIALIZE;
-        for ( int j = INITIALIZE; j < size; j++ ) {
-            if ( grid[i][j] == g->stone ) {
-                count++;
-                if ( count >= WIN_CONDITION ) {
-                    g->state = GAME_STATE_FINISHED;
-                    g->winner = g->stone;
-                    return true;
-                }
-            } else {
-                count = INITIALIZE;
-            }
-        }
+unsigned char game_replay_at( game* g, size_t position )
+{
+    if ( !g ) {
+        return NULL_POINTER_ERR;
     }
 
-    // Check vertical
-    for ( int j = INITIALIZE; j < size; j++ ) {
-        count = INITIALIZE;
-        for ( int i = INITIALIZE; i < size; i++ ) {
-            if ( grid[i][j] == g->stone ) {
-                count++;
-                if ( count >= WIN_CONDITION ) {
-                    g->state = GAME_STATE_FINISHED;
-                    g->winner = g->stone;
-                    return true;
-                }
-            } else {
-                count = INITIALIZE;
-            }
-        }
+    if ( position > g->moves_count ) {
+        return ARGUMENT_ERR;
     }
 
-    // Check main diagonals from top-left to bottom-right
-    for ( int i = INITIALIZE; i <= size - WIN_CONDITION; i++ ) {
-        for ( int j = INITIALIZE; j <= size - WIN_CONDITION; j++ ) {
-            count = INITIALIZE;
-            for ( int k = INITIALIZE; k < WIN_CONDITION; k++ ) {
-                if ( grid[i + k][j + k] == g->stone ) {
-                    count++;
-                    if ( count >= WIN_CONDITION ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = g->stone;
-                        return true;
-                    }
-                } else {
-                    break;
-                }
-            }
-        }
-    }
+    // Storing the cursor that finds the position
+    game_cursor* cursor = game_cursor_create( g, INITIALIZE );
 
-    // Check secondary diagonals from bottom-left to top-right
-    for ( int i = INITIALIZE; i <= size - WIN_CONDITION; i++ ) {
-        for ( int j = INITIALIZE; j <= size - WIN_CONDITION; j++ ) {
-            count = INITIALIZE;
-            for ( int k = INITIALIZE; k < WIN_CONDITION; k++ ) {
-                if ( grid[i - k][j + k] == g->stone ) {
-                    count++;
-                    if ( count >= WIN_CONDITION ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = g->stone;
-                        return true;
-                    }
-                } else {
-                    break;
-                }
-            }
-        }
-    }
+    // Storing the moves list up to position
+    char* moves_list = malloc( position * REPLAY_ENTRY_LENGTH + 1 );
 
-    // Check if the board is full
-    if ( board_is_full( g->board ) ) {
-        g->state = GAME_STATE_FINISHED;
-        return false;
-    }
+    // Storing the length of the formatted moves list
+    size_t moves_length = INITIALIZE;
 
-    // No winner
-    return true;
-}
+    if ( !cursor || !moves_list ) {
+        game_cursor_delete( cursor );
+        free( moves_list );
+        return MEMORY_ERR;
+    }
 
-/**
- * This function helps sort and order the patterns to make it more apparent
- * which patterns are repeats and which may be new instances
- * @param pattern of at most 4 pairs of x and y coordinates to be sorted
- */
-static void normalize_pattern( int pattern[4][2] ) {
+    game_cursor_seek( cursor, position );
+    board_print( cursor->board, true );
 
-    // Sort the pattern coordinates to ensure a unique representation
-    for ( int i = INITIALIZE; i < 3; i++ ) {
+    if ( position > INITIALIZE && position == g->moves_count ) {
+        game_replay_conclusion( g );
+    }
 
-        for ( int j = i + 1; j < OPEN_FOUR; j++ ) {
+    for ( size_t i = INITIALIZE; i < position; i++ ) {
+        moves_length += game_replay_entry( g, i, moves_list + moves_length );
+    }
 
-            if ( pattern[i][INITIALIZE] > pattern[j][INITIALIZE] || 
-               ( pattern[i][INITIALIZE] == pattern[j][INITIALIZE] && pattern[i][1] > pattern[j][1] ) ) {
+    printf( "Moves:\n" );
+    fwrite( moves_list, 1, moves_length, stdout );
 
-                // Swap the coordinates
-                int temp_x = pattern[i][INITIALIZE];
-                int temp_y = pattern[i][1];
+    if ( position > INITIALIZE && g->moves[position - 1].stone != WHITE_STONE ) {
+        printf( "\n" );
+    }
 
-                pattern[i][INITIALIZE] = pattern[j][INITIALIZE];
-                pattern[i][1] = pattern[j][1];
+    free( moves_list );
+    game_cursor_delete( cursor );
 
-                pattern[j][INITIALIZE] = temp_x;
-                pattern[j][1] = temp_y;
-            }
-        }
-    }
+    return SUCCESS;
 }
 
+game_cursor* game_cursor_create( game* g, size_t interval )
+{
+    if ( !g ) {
+        return NULL;
+    }
 
-/**
- * This function checks for winning conditions in renju just for the black player.
- * If five or more consecutive stones are found in any direction (horizontal, vertical, main diagonals, secondary diagonals), 
- * it updates the game state and winner and returns true. If a forbidden move is played, it automatically exits.
- * If the board is full, it updates the game state to finished and returns false. Otherwise, returns true.
- * @param g A pointer to the game struct.
- * @param x The x-coordinate of the last move.
- * @param y The y-coordinate of the last move.
- * @return bool true if the game continues, false if it stops.
- */
-static bool game_renju_black( game* g, unsigned char x, unsigned char y ) {
+    // Create the dynamically allocated cursor
+    game_cursor* Cursor = ( game_cursor* ) calloc( 1, sizeof( game_cursor ) );
 
-    // Casting the board grid to grid
-    unsigned char ( *grid )[g->board->size] = ( unsigned char( * )[g->board->size] ) g->board->grid;
+    if ( !Cursor ) {
+        return NULL;
+    }
 
-    // Storing the size of the board
-    int size = g->board->size;
+    Cursor->game = g;
+    Cursor->interval = interval ? interval : REPLAY_CHECKPOINT_INTERVAL;
+    Cursor->board = board_create( g->board->size );
+    Cursor->checkpoints = ( board** ) calloc( g->moves_count / Cursor->interval + 1, sizeof( board* ) );
 
-    // Storing the count of open fours
-    int open_four_count = INITIALIZE;
+    if ( !Cursor->board || !Cursor->checkpoints ) {
+        game_cursor_delete( Cursor );
+        return NULL;
+    }
 
-    // Storing the count of half open fours
-    int half_open_four_count = INITIALIZE;
+    // One pass over the moves, keeping a copy of the board at every checkpoint
+    for ( size_t i = INITIALIZE; ; i++ ) {
 
-    // Storing the count of open threes
-    int open_three_count = INITIALIZE;
-    
-    // Storing the count in the positive direction for a given orientation
-    int pos_count;
+        if ( i % Cursor->interval == 0 ) {
 
-    // Storing the count in the neg direction for a given orientation
-    int neg_count;
+            // Storing the checkpoint after i moves
+            board* checkpoint = board_create( g->board->size );
 
-    // Array to store up to 3 sets of 4 coordinate pairs
-    int pattern_coords[3][4][2];
+            if ( !checkpoint ) {
+                game_cursor_delete( Cursor );
+                return NULL;
+            }
 
-    // How many patterns of valid open threes, or fours have been stored yet
-    int pattern_count = INITIALIZE;
+            board_copy( checkpoint, Cursor->board );
+            Cursor->checkpoints[Cursor->checkpoints_count++] = checkpoint;
+        }
 
-    // Counting inner spaces for open three
-    int pattern_spaces = INITIALIZE;
+        if ( i == g->moves_count ) {
+            break;
+        }
 
-    // Counting inner spaces for the positive traversal
-    int pos_spaces = INITIALIZE;
+        board_set( Cursor->board, g->moves[i].x, g->moves[i].y, g->moves[i].stone );
+    }
 
-    // Counting inner spaces for the negative traversal
-    int neg_spaces = INITIALIZE;
+    Cursor->position = INITIALIZE;
+    board_copy( Cursor->board, Cursor->checkpoints[0] );
 
-    // Initialize the temporary array
-    memset( pattern_coords, BLANK_COORD, sizeof( pattern_coords ) );
+    return Cursor;
+}
 
-    // The move 
-    int the_move[2] = { y, x };
+unsigned char game_cursor_delete( game_cursor* c )
+{
+    if ( !c ) {
+        return NULL_POINTER_ERR;
+    }
 
-    for ( int i = INITIALIZE; i < size; i++ ) {
+    for ( size_t i = INITIALIZE; i < c->checkpoints_count; i++ ) {
+        board_delete( c->checkpoints[i] );
+    }
 
-        for ( int j = INITIALIZE; j < size; j++ ) {
+    if ( c->board ) {
+        board_delete( c->board );
+    }
 
-            if ( grid[i][j] != BLACK_STONE ) continue;
+    free( c->checkpoints );
+    free( c );
 
-            // Check horizontal
-            pos_count = INITIALIZE;
-            neg_count = INITIALIZE;
-            int new_pattern[4][2] = { {BLANK_COORD, BLANK_COORD}, {BLANK_COORD, BLANK_COORD}, {BLANK_COORD, BLANK_COORD}, {BLANK_COORD, BLANK_COORD} };
+    return SUCCESS;
+}
 
-            // Check forward direction on horizontal
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
+bool game_cursor_seek( game_cursor* c, size_t position )
+{
+    if ( position > c->game->moves_count ) {
+        return false;
+    }
 
-                if ( j + k >= size ) break;
+    // Storing the last checkpoint at or before position
+    size_t checkpoint = position / c->interval;
 
-                if ( grid[i][j + k] == BLACK_STONE || grid[i][j + k] == EMPTY_INTERSECTION ) {
-                    
-                    if ( grid[i][j + k] == BLACK_STONE ) {
+    if ( position < c->position || c->position < checkpoint * c->interval ) {
+        board_copy( c->board, c->checkpoints[checkpoint] );
+        c->position = checkpoint * c->interval;
+    }
 
-                        new_pattern[pos_count][INITIALIZE] = i;  // Store x coordinate
-                        new_pattern[pos_count][1] = j + k;  // Store y coordinate
-                        pos_count++;
+    for ( ; c->position < position; c->position++ ) {
+        board_set( c->board, c->game->moves[c->position].x, c->game->moves[c->position].y, c->game->moves[c->position].stone );
+    }
 
-                    } else if ( grid[i][j + k] == EMPTY_INTERSECTION ) {
+    return true;
+}
 
-                        pos_spaces++;
+bool game_cursor_step( game_cursor* c, bool forward )
+{
+    if ( forward ) {
+        return game_cursor_seek( c, c->position + 1 );
+    }
 
-                        if ( grid[i][j + k + ONE_SPACE_OUT] == BLACK_STONE ) {
+    return c->position > INITIALIZE && game_cursor_seek( c, c->position - 1 );
+}
 
-                            if ( grid[i][j + k + TWO_SPACE_OUT] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-                            
-                            continue;
+/**
+ * The progress of game_batch() through its move stream.
+ */
+typedef struct {
+    game* g;
+    unsigned char type;
+    FILE* out;
+    size_t games;
+    size_t tokens;
+    bool failed;
+    char bad_move[DEFAULT_STRING_LENGTH];
+} game_batch_state;
 
-                        } else {
-                            break;
-                        }
-                    }
+/**
+ * This function makes sure the batch has a game of the given size with no moves on it,
+ * taking back the moves of the previous game if the size is unchanged.
+ * @param batch A pointer to the batch progress.
+ * @param size The board size of the next game.
+ * @return bool true if the game is ready, false if it can't be created.
+ */
+static bool game_batch_start( game_batch_state* batch, unsigned char size )
+{
+    if ( batch->g && batch->g->board->size == size ) {
+        while ( game_unplace_stone( batch->g ) );
+        return true;
+    }
 
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < 4; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
+    if ( batch->g ) {
+        game_delete( batch->g );
+    }
 
-                    // Check for open fours 
-                    if ( pos_count == OPEN_FOUR && j - ONE_SPACE_OUT >= INITIALIZE && j + pos_count < size &&
-                        grid[i][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION &&  grid[i][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) {
+    batch->g = game_create( size, batch->type );
 
-                        normalize_pattern( new_pattern );
+    return batch->g != NULL;
+}
 
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
+/**
+ * This function applies one whitespace-separated token of the move stream to the current game.
+ * @param batch A pointer to the batch progress.
+ * @param token The token, NUL-terminated.
+ * @return bool false if a game can't be created.
+ */
+static bool game_batch_token( game_batch_state* batch, const char* token )
+{
+    if ( batch->tokens++ == INITIALIZE ) {
 
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
+        // Storing the board size given at the start of the line, if the whole token is a number
+        char* end = NULL;
+        long size = strtol( token, &end, 10 );
 
-                        open_four_count++;
+        if ( *end == '\0' && ( size == 15 || size == 17 || size == 19 ) ) {
+            return game_batch_start( batch, size );
+        }
 
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
+        if ( !game_batch_start( batch, BATCH_DEFAULT_SIZE ) ) {
+            return false;
+        }
+    }
 
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
+    if ( batch->failed ) {
+        return true;
+    }
 
-                        }
+    // Storing the coordinates of the move
+    unsigned char x;
+    unsigned char y;
 
-                    }  else if ( pos_count == OPEN_FOUR && j - ONE_SPACE_OUT >= INITIALIZE && j + pos_count < size &&
-                        ( ( grid[i][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION ) ^ ( grid[i][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) ) ) {
+    if ( batch->g->state != GAME_STATE_PLAYING || board_coord( batch->g->board, token, &x, &y ) != SUCCESS ||
+         !game_place_stone( batch->g, x, y ) ) {
+        batch->failed = true;
+        strncpy( batch->bad_move, token, DEFAULT_STRING_LENGTH - 1 );
+        batch->bad_move[DEFAULT_STRING_LENGTH - 1] = '\0';
+    }
 
-                        normalize_pattern( new_pattern );
+    return true;
+}
 
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
+/**
+ * This function writes the result record of the current game at the end of a line, if the line held a game.
+ * @param batch A pointer to the batch progress.
+ */
+static void game_batch_finish( game_batch_state* batch )
+{
+    if ( batch->tokens == INITIALIZE ) {
+        return;
+    }
 
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
+    batch->games++;
 
-                        half_open_four_count++;
+    if ( batch->failed ) {
+        fprintf( batch->out, "%zu %zu invalid %s\n", batch->games, batch->g->moves_count, batch->bad_move );
+    } else {
+        fprintf( batch->out, "%zu %zu %d %d\n", batch->games, batch->g->moves_count,
+                 batch->g->state == GAME_STATE_PLAYING ? GAME_STATE_STOPPED : batch->g->state, batch->g->winner );
+    }
 
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
+    batch->tokens = INITIALIZE;
+    batch->failed = false;
+}
 
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
 
-                        }
+unsigned char game_batch( FILE* in, FILE* out, unsigned char game_type )
+{
+    // Storing the progress of the batch
+    game_batch_state batch = { NULL, game_type, out, INITIALIZE, INITIALIZE, false, "" };
 
-                    } else if ( pos_count == OPEN_THREE && j - ONE_SPACE_OUT >= INITIALIZE && j + pos_count < size && pattern_spaces == INITIALIZE &&
-                        grid[i][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) {
+    // Storing a block of the stream and the token being read, which may span blocks
+    char chunk[BATCH_CHUNK];
+    char token[DEFAULT_STRING_LENGTH];
+    size_t token_length = INITIALIZE;
 
-                        normalize_pattern( new_pattern );
+    // Storing the number of bytes in the block
+    size_t length;
 
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
+    // Storing whether the batch ran into an error
+    unsigned char status = SUCCESS;
 
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
+    while ( status == SUCCESS && ( length = fread( chunk, 1, sizeof( chunk ), in ) ) > INITIALIZE ) {
+        for ( size_t i = INITIALIZE; i < length && status == SUCCESS; i++ ) {
 
-                        open_three_count++;
+            // Storing the current character
+            char c = chunk[i];
 
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
+            if ( c != ' ' && c != '\t' && c != '\r' && c != '\n' ) {
+                // Overlong tokens are cut short, they are invalid moves either way
+                if ( token_length < DEFAULT_STRING_LENGTH - 1 ) {
+                    token[token_length++] = c;
+                }
+                continue;
+            }
 
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
+            if ( token_length > INITIALIZE ) {
+                token[token_length] = '\0';
+                token_length = INITIALIZE;
+                if ( !game_batch_token( &batch, token ) ) {
+                    status = MEMORY_ERR;
+                }
+            }
 
-                        }      
+            if ( c == '\n' ) {
+                game_batch_finish( &batch );
+            }
+        }
+    }
 
-                    } else if ( pos_count == OPEN_THREE && j - ONE_SPACE_OUT >= INITIALIZE && j + OPEN_FOUR < size && pattern_spaces == 1 &&
-                        grid[i][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i][j + OPEN_FOUR] == EMPTY_INTERSECTION && is_new_instance ) {
+    if ( status == SUCCESS && token_length > INITIALIZE ) {
+        token[token_length] = '\0';
+        if ( !game_batch_token( &batch, token ) ) {
+            status = MEMORY_ERR;
+        }
+    }
 
-                        normalize_pattern( new_pattern );
+    if ( status == SUCCESS ) {
+        game_batch_finish( &batch );
+    }
 
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
+    if ( status == SUCCESS && ferror( in ) ) {
+        status = FILE_INPUT_ERR;
+    }
 
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
+    if ( batch.g ) {
+        game_delete( batch.g );
+    }
 
-                        open_three_count++;
+    return status;
+}
 
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
 
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
+bool game_check( game* g, unsigned char* state, unsigned char* winner, size_t* played )
+{
+    *played = INITIALIZE;
+    *state = GAME_STATE_STOPPED;
+    *winner = EMPTY_INTERSECTION;
 
-                        }      
+    // Storing the game the moves are played again on
+    game* replayed = game_create( g->board->size, g->type );
 
-                    } else if ( pos_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
+    if ( !replayed ) {
+        return false;
+    }
 
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
+    while ( *played < g->moves_count && replayed->state == GAME_STATE_PLAYING &&
+            game_place_stone( replayed, g->moves[*played].x, g->moves[*played].y ) ) {
+        ( *played )++;
+    }
 
-                    } else if ( pos_count == WIN_CONDITION && pos_spaces == INITIALIZE && grid[i][j + k + ONE_SPACE_OUT] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
+    *state = replayed->state == GAME_STATE_PLAYING ? GAME_STATE_STOPPED : replayed->state;
+    *winner = replayed->winner;
+    game_delete( replayed );
 
-                } else {
-                    break;
-                }
-            }
+    return *played == g->moves_count && *state == g->state && *winner == g->winner;
+}
 
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-            
-            // Check backward direction on horizontal
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
+/**
+ * This function returns the length of the run of consecutive set bits of line that contains bit pos,
+ * or 0 if bit pos isn't set.
+ * @param line The bitmask of a board line as returned by board_line().
+ * @param pos The bit index of the intersection in line.
+ * @return int The number of consecutive stones through pos.
+ */
+static int game_line_run( uint32_t line, unsigned char pos ) {
 
-                if ( j - k < INITIALIZE ) break;
+    if ( !( line & ( ( uint32_t ) 1 << pos ) ) ) {
+        return INITIALIZE;
+    }
 
-                if ( grid[i][j - k] == BLACK_STONE || grid[i][j - k] == EMPTY_INTERSECTION ) {
+    // Stones from pos upwards, pos included; a line never uses bit 31 so the complement is never zero
+    int up = __builtin_ctz( ~( line >> pos ) );
 
-                    if ( grid[i][j - k] == BLACK_STONE ) {
+    // Stones from pos downwards, pos included, counted from the top after shifting pos to bit 31
+    int down = __builtin_clz( ~( line << ( 31 - pos ) ) );
 
-                        new_pattern[neg_count][INITIALIZE] = i;  // Store x coordinate
-                        new_pattern[neg_count][1] = j - k;  // Store y coordinate
-                        neg_count++;
+    return up + down - 1;
+}
 
-                    } else if ( grid[i][j - k] == EMPTY_INTERSECTION ) {
-                        
-                        neg_spaces++;
+/**
+ * This function checks for winning conditions in freestyle Gomoku.
+ * Only the four lines through the last move can have changed, so only those are checked.
+ * If five or more consecutive stones are found in any direction (horizontal, vertical, main diagonals, secondary diagonals), 
+ * it updates the game state and winner and returns true. If the board is full, it updates the game state to finished and returns false. Otherwise, returns true.
+ * @param g A pointer to the game struct.
+ * @param x The x-coordinate of the last move.
+ * @param y The y-coordinate of the last move.
+ * @return bool true if the game continues or is won, false if it stops.
+ */
+static bool game_freestyle_gomoku( game* g, unsigned char x, unsigned char y ) {
 
-                        if ( grid[i][j - k - ONE_SPACE_OUT] == BLACK_STONE ) {
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
 
-                            if ( grid[i][j - k - TWO_SPACE_OUT] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
+        // Storing the stones of the player on the line through the move
+        uint32_t line = board_line( g->board, x, y, direction, g->stone );
 
-                            continue;
+        if ( game_line_run( line, board_line_index( direction, x, y ) ) >= WIN_CONDITION ) {
+            g->state = GAME_STATE_FINISHED;
+            g->winner = g->stone;
+            return true;
+        }
+    }
 
-                        } else {
-                            break;
-                        }
-                    }
+    // Check if the board is full
+    if ( board_is_full( g->board ) ) {
+        g->state = GAME_STATE_FINISHED;
+        return false;
+    }
 
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
+    // No winner
+    return true;
+}
 
-                    // Check for open fours 
-                    if ( neg_count == OPEN_FOUR && j + ONE_SPACE_OUT < size && j - neg_count >= INITIALIZE &&
-                        grid[i][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i][j - neg_count] == EMPTY_INTERSECTION && is_new_instance ) {
+/**
+ * This function checks for winning conditions in renju just for the black player.
+ * Only the four lines through the last move are examined, see rules_renju_black().
+ * If exactly five consecutive stones are found in any direction (horizontal, vertical, main diagonals, secondary diagonals), 
+ * it updates the game state and winner and returns true. If a forbidden move is played (overline, four-four or three-three),
+ * it updates the game state to forbidden with white as the winner and returns true.
+ * If the board is full, it updates the game state to finished and returns false. Otherwise, returns true.
+ * @param g A pointer to the game struct.
+ * @param x The x-coordinate of the last move.
+ * @param y The y-coordinate of the last move.
+ * @return bool true if the game continues, false if it stops.
+ */
+static bool game_renju_black( game* g, unsigned char x, unsigned char y ) {
 
-                        normalize_pattern( new_pattern );
+    // Storing the classification of the move
+    unsigned char result = rules_renju_black( g->board, x, y );
 
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    }  else if ( neg_count == OPEN_FOUR && j + ONE_SPACE_OUT < size && j - neg_count >= INITIALIZE &&
-                        ( ( grid[i][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION ) ^ ( grid[i][j - neg_count] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_THREE && j + ONE_SPACE_OUT < size && j - neg_count >= INITIALIZE && pattern_spaces == INITIALIZE &&
-                        grid[i][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i][j - neg_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OPEN_THREE && j + ONE_SPACE_OUT < size && j - OPEN_FOUR >= INITIALIZE && pattern_spaces == 1 &&
-                        grid[i][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i][j - OPEN_FOUR] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( neg_count == WIN_CONDITION && neg_spaces == INITIALIZE && grid[i][j - k - ONE_SPACE_OUT] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-
-            // Check vertical
-            pos_count = INITIALIZE;
-            neg_count = INITIALIZE;
-
-            pos_spaces = INITIALIZE;
-            neg_spaces = INITIALIZE;
-
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-
-            // Check forward vertical
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
-
-                if ( i + k >= size ) break;
-
-                if ( grid[i + k][j] == BLACK_STONE || grid[i + k][j] == EMPTY_INTERSECTION ) {
-
-                    if ( grid[i + k][j] == BLACK_STONE ) {
-
-                        new_pattern[pos_count][INITIALIZE] = i + k;  // Store x coordinate
-                        new_pattern[pos_count][1] = j;  // Store y coordinate
-                        pos_count++;
-
-                    } else if ( grid[i + k][j] == EMPTY_INTERSECTION ) {
-                        
-                        pos_spaces++;
-
-                        if ( grid[i + k + ONE_SPACE_OUT][j] == BLACK_STONE ) {
-
-                            if ( grid[i + k + TWO_SPACE_OUT][j] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-
-                            continue;
-
-                        } else {
-                            break;
-                        }
-                    }
-
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
-
-                    // Check for open fours before counting
-                    if ( pos_count == OPEN_FOUR && i - ONE_SPACE_OUT >= INITIALIZE && i + pos_count < size &&
-                        grid[i - ONE_SPACE_OUT][j] == EMPTY_INTERSECTION && grid[i + pos_count][j] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    }  else if ( pos_count == OPEN_FOUR && i - ONE_SPACE_OUT >= INITIALIZE && i + pos_count < size &&
-                        ( ( grid[i - ONE_SPACE_OUT][j] == EMPTY_INTERSECTION ) ^ ( grid[i + pos_count][j] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern )  ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( pos_count == OPEN_THREE && i - ONE_SPACE_OUT >= INITIALIZE && i + pos_count < size && pattern_spaces == INITIALIZE &&
-                        grid[i - ONE_SPACE_OUT][j] == EMPTY_INTERSECTION && grid[i + pos_count][j] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( pos_count == OPEN_THREE && i - ONE_SPACE_OUT >= INITIALIZE && i + OPEN_FOUR < size && pattern_spaces == 1 &&
-                        grid[i - ONE_SPACE_OUT][j] == EMPTY_INTERSECTION && grid[i + OPEN_FOUR][j] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( pos_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( pos_count == WIN_CONDITION && pos_spaces == INITIALIZE && grid[i + k + ONE_SPACE_OUT][j] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-
-            // Check backward vertical
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
-
-                if ( i - k < INITIALIZE ) break;
-
-                if ( grid[i - k][j] == BLACK_STONE || grid[i - k][j] == EMPTY_INTERSECTION ) {
-
-                    if ( grid[i - k][j] == BLACK_STONE ) {
-
-                        new_pattern[neg_count][INITIALIZE] = i - k;  // Store x coordinate
-                        new_pattern[neg_count][1] = j;  // Store y coordinate
-                        neg_count++;
-
-                    } else if ( grid[i - k][j] == EMPTY_INTERSECTION ) {
-
-                        neg_spaces++;
-
-                        if ( grid[i - k - ONE_SPACE_OUT][j] == BLACK_STONE ) {
-
-                            if ( grid[i - k - TWO_SPACE_OUT][j] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-
-                            continue;
-
-                        } else {
-                            break;
-                        }
-                    }
-
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
-
-                    // Check for open fours 
-                    if ( neg_count == OPEN_FOUR && i + ONE_SPACE_OUT < size && i - neg_count >= INITIALIZE &&
-                        grid[i + ONE_SPACE_OUT][j] == EMPTY_INTERSECTION && grid[i - neg_count][j] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_FOUR && i + ONE_SPACE_OUT < size && i - neg_count >= INITIALIZE &&
-                        ( ( grid[i + ONE_SPACE_OUT][j] == EMPTY_INTERSECTION ) ^ ( grid[i - neg_count][j] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_THREE && i + ONE_SPACE_OUT < size && i - neg_count >= INITIALIZE && pattern_spaces == INITIALIZE &&
-                        grid[i + ONE_SPACE_OUT][j] == EMPTY_INTERSECTION && grid[i - neg_count][j] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OPEN_THREE && i + 1 < size && i - OPEN_FOUR >= INITIALIZE && pattern_spaces == 1 &&
-                        grid[i + ONE_SPACE_OUT][j] == EMPTY_INTERSECTION && grid[i - OPEN_FOUR][j] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( neg_count == WIN_CONDITION && neg_spaces == INITIALIZE && grid[i - k - ONE_SPACE_OUT][j] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-
-            // Check main diagonals from bottom-left to top-right
-            pos_count = INITIALIZE;
-            neg_count = INITIALIZE;
-
-            pos_spaces = INITIALIZE;
-            neg_spaces = INITIALIZE;
-
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-
-            // Check forward traversal of diagonal of type '/'
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
-
-                if ( i + k >= size || j + k >= size ) break;
-
-                if ( grid[i + k][j + k] == BLACK_STONE || grid[i + k][j + k] == EMPTY_INTERSECTION ) {
-
-                    if ( grid[i + k][j + k] == BLACK_STONE ) {
-
-                        new_pattern[pos_count][INITIALIZE] = i + k;  // Store x coordinate
-                        new_pattern[pos_count][1] = j + k;  // Store y coordinate
-                        pos_count++;
-
-                    } else if ( grid[i + k][j + k] == EMPTY_INTERSECTION ) {
-
-                        pos_spaces++;
-
-                        if ( grid[i + k + ONE_SPACE_OUT][j + k + ONE_SPACE_OUT] == BLACK_STONE ) {
-
-                            if ( grid[i + k + TWO_SPACE_OUT][j + k + TWO_SPACE_OUT] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-
-                            continue;
-
-                        } else {
-                            break;
-                        }
-                    }
-        
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
-
-                    // Check for open fours
-                    if ( pos_count == OPEN_FOUR && i - ONE_SPACE_OUT >= INITIALIZE && j - ONE_SPACE_OUT >= INITIALIZE && i + pos_count < size && j + pos_count < size &&
-                        grid[i - ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i + pos_count][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( pos_count == OPEN_FOUR && i - ONE_SPACE_OUT >= INITIALIZE && j - ONE_SPACE_OUT >= INITIALIZE && i + pos_count < size && j + pos_count < size &&
-                        ( ( grid[i - ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION ) ^ ( grid[i + pos_count][j + pos_count] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( pos_count == OPEN_THREE && i - ONE_SPACE_OUT >= INITIALIZE && j - ONE_SPACE_OUT >= INITIALIZE && i + pos_count < size && j + pos_count < size && pattern_spaces == INITIALIZE &&
-                        grid[i - ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i + pos_count][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( pos_count == OPEN_THREE && i - ONE_SPACE_OUT >= INITIALIZE && j - ONE_SPACE_OUT >= INITIALIZE && i + OPEN_FOUR < size && j + OPEN_FOUR < size && pattern_spaces == 1
-                        && grid[i - ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i + OPEN_FOUR][j + OPEN_FOUR] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( pos_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( pos_count == WIN_CONDITION && pos_spaces == INITIALIZE && grid[i + k + ONE_SPACE_OUT][j + k + ONE_SPACE_OUT] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-            
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-
-            // Check backwards traveral of diagonal of type '/'
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
-
-                if ( i - k < INITIALIZE || j - k < INITIALIZE ) break;
-
-                if ( grid[i - k][j - k] == BLACK_STONE || grid[i - k][j - k] == EMPTY_INTERSECTION ) {
-
-                    if ( grid[i - k][j - k] == BLACK_STONE ) {
-
-                        new_pattern[neg_count][INITIALIZE] = i - k;  // Store x coordinate
-                        new_pattern[neg_count][1] = j - k;  // Store y coordinate
-                        neg_count++;
-
-                    } else if ( grid[i - k][j - k] == EMPTY_INTERSECTION ) {
-
-                        neg_spaces++;
-
-                        if ( grid[i - k - ONE_SPACE_OUT][j - k - ONE_SPACE_OUT] == BLACK_STONE ) {
-
-                            if ( grid[i - k - TWO_SPACE_OUT][j - k - TWO_SPACE_OUT] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-
-                            continue;
-
-                        } else {
-                            break;
-                        }
-                    }
-
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
-
-                    // Check for open fours
-                    if ( neg_count == OPEN_FOUR && i + ONE_SPACE_OUT < size && j + ONE_SPACE_OUT < size && i - neg_count >= INITIALIZE && j - neg_count >= INITIALIZE &&
-                        grid[i + ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i - neg_count][j - neg_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-                        
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_FOUR && i + ONE_SPACE_OUT < size && j + ONE_SPACE_OUT < size && i - neg_count >= INITIALIZE && j - neg_count >= INITIALIZE &&
-                        ( ( grid[i + ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION ) ^ ( grid[i - neg_count][j - neg_count] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_THREE && i + ONE_SPACE_OUT < size && j + ONE_SPACE_OUT < size && i - neg_count >= INITIALIZE && j - neg_count >= INITIALIZE && pattern_spaces == INITIALIZE &&
-                        grid[i + ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i - neg_count][j - neg_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OPEN_THREE && i + ONE_SPACE_OUT < size && j + ONE_SPACE_OUT < size && i - OPEN_FOUR >= INITIALIZE && j - OPEN_FOUR >= INITIALIZE && pattern_spaces == 1 &&
-                        grid[i + ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i - OPEN_FOUR][j - OPEN_FOUR] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( neg_count == WIN_CONDITION && neg_spaces == INITIALIZE && grid[i - k - ONE_SPACE_OUT][j - k - ONE_SPACE_OUT] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-
-            // Check secondary diagonals from top-left to bottom-right
-            pos_count = INITIALIZE;
-            neg_count = INITIALIZE;
-
-            pos_spaces = INITIALIZE;
-            neg_spaces = INITIALIZE;
-
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-
-            // Check forward traveral of secondary diagonal of type '\'
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
-
-                if ( i - k < INITIALIZE || j + k >= size ) break;
-
-                if ( grid[i - k][j + k] == BLACK_STONE || grid[i - k][j + k] == EMPTY_INTERSECTION ) {
-
-                    if ( grid[i - k][j + k] == BLACK_STONE ) {
-
-                        new_pattern[pos_count][INITIALIZE] = i - k;  // Store x coordinate
-                        new_pattern[pos_count][1] = j + k;  // Store y coordinate
-                        pos_count++;
-
-                    } else if ( grid[i - k][j + k] == EMPTY_INTERSECTION ) {
-                        
-                        pos_spaces++;
-
-                        if ( grid[i - k - ONE_SPACE_OUT][j + k + ONE_SPACE_OUT] == BLACK_STONE ) {
-
-                            if ( grid[i - k - TWO_SPACE_OUT][j + k + TWO_SPACE_OUT] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-
-                            continue;
-
-                        } else {
-                            break;
-                        }
-                    }
-
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
-
-                    // Check for open fours 
-                    if ( pos_count == OPEN_FOUR && i + ONE_SPACE_OUT < size && j - ONE_SPACE_OUT >= INITIALIZE && i - pos_count >= INITIALIZE && j + pos_count < size &&
-                        grid[i + ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i - pos_count][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern(new_pattern);
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-                        
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( pos_count == OPEN_FOUR && i + ONE_SPACE_OUT < size && j - ONE_SPACE_OUT >= INITIALIZE && i - pos_count >= INITIALIZE && j + pos_count < size &&
-                        ( ( grid[i + ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION ) ^ ( grid[i - pos_count][j + pos_count] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( pos_count == OPEN_THREE && i + ONE_SPACE_OUT < size && j - ONE_SPACE_OUT >= INITIALIZE && i - pos_count >= INITIALIZE && j + pos_count < size && pattern_spaces == INITIALIZE &&
-                        grid[i + ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i - pos_count][j + pos_count] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( pos_count == OPEN_THREE && i + ONE_SPACE_OUT < size && j - ONE_SPACE_OUT >= INITIALIZE && i - OPEN_FOUR >= INITIALIZE && j + OPEN_FOUR < size && pattern_spaces == 1
-                        && grid[i + ONE_SPACE_OUT][j - ONE_SPACE_OUT] == EMPTY_INTERSECTION && grid[i - OPEN_FOUR][j + OPEN_FOUR] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( pos_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( pos_count == WIN_CONDITION && pos_spaces == INITIALIZE && grid[i - k - ONE_SPACE_OUT][j + k + ONE_SPACE_OUT] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-
-            pattern_spaces = INITIALIZE;
-            memset( new_pattern, BLANK_COORD, sizeof( new_pattern ) ); // Reset the pattern array
-
-            // Check backward traversal of secondary diagonal of type '\'
-            for ( int k = INITIALIZE; k < OVERLINE; k++ ) {
-
-                if ( i + k >= size || j - k < INITIALIZE ) break;
-
-                if ( grid[i + k][j - k] == BLACK_STONE || grid[i + k][j - k] == EMPTY_INTERSECTION ) {
-
-                    if ( grid[i + k][j - k] == BLACK_STONE ) {
-
-                        new_pattern[neg_count][INITIALIZE] = i + k;  // Store x coordinate
-                        new_pattern[neg_count][1] = j - k;  // Store y coordinate
-                        neg_count++;
-
-                    } else if ( grid[i + k][j - k] == EMPTY_INTERSECTION ) {
-                        
-                        neg_spaces++;
-
-                        if ( grid[i + k + ONE_SPACE_OUT][j - k - ONE_SPACE_OUT] == BLACK_STONE ) {
-
-                            if ( grid[i + k + TWO_SPACE_OUT][j - k - TWO_SPACE_OUT] == EMPTY_INTERSECTION ) {
-                                pattern_spaces++;
-                            }
-
-                            continue;
-
-                        } else {
-                            break;
-                        }
-                    }
-
-                    // checking to see if it is a new instance
-                    bool is_new_instance = false;
-                    for ( int l = INITIALIZE; l < OPEN_FOUR; l++ ) {
-                        if ( memcmp( new_pattern[l], the_move, sizeof( the_move ) ) == INITIALIZE ) {
-                            is_new_instance = true;
-                            break;
-                        }
-                    }
-
-                    // Check for open fours
-                    if ( neg_count == OPEN_FOUR && i - ONE_SPACE_OUT >= INITIALIZE && j + ONE_SPACE_OUT < size && i + neg_count < size && j - neg_count >= INITIALIZE &&
-                         grid[i + neg_count][j - neg_count] == EMPTY_INTERSECTION && grid[i - ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_four_count++;
-
-                        if ( open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_FOUR && i - ONE_SPACE_OUT >= INITIALIZE && j + ONE_SPACE_OUT < size && i + neg_count < size && j - neg_count >= INITIALIZE &&
-                        ( ( grid[i + neg_count][j - neg_count] == EMPTY_INTERSECTION ) ^ ( grid[i - ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION ) ) && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        half_open_four_count++;
-
-                        if ( half_open_four_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }
-
-                    } else if ( neg_count == OPEN_THREE && i - ONE_SPACE_OUT >= INITIALIZE && j + ONE_SPACE_OUT < size && i + neg_count < size && j - neg_count >= INITIALIZE && pattern_spaces == INITIALIZE &&
-                         grid[i + neg_count][j - neg_count] == EMPTY_INTERSECTION && grid[i - ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OPEN_THREE && i - ONE_SPACE_OUT >= INITIALIZE && j + ONE_SPACE_OUT < size && i + OPEN_FOUR < size && j - OPEN_FOUR >= INITIALIZE && pattern_spaces == 1 &&
-                         grid[i + OPEN_FOUR][j - OPEN_FOUR] == EMPTY_INTERSECTION && grid[i - ONE_SPACE_OUT][j + ONE_SPACE_OUT] == EMPTY_INTERSECTION && is_new_instance ) {
-
-                        normalize_pattern( new_pattern );
-
-                        bool is_duplicate = false;
-                        for ( int p = INITIALIZE; p <= pattern_count; p++ ) {
-                            if ( memcmp( pattern_coords[p], new_pattern, sizeof( new_pattern ) ) == INITIALIZE ) {
-                                is_duplicate = true;
-                                break;
-                            }
-                        }
-
-                        if ( !is_duplicate ) {
-                            memcpy( pattern_coords[pattern_count], new_pattern, sizeof( new_pattern ) );
-                            pattern_count++;
-                        } else {
-                            break;
-                        }
-
-                        open_three_count++;
-
-                        if ( open_three_count >= MAX_VIOLATIONS ) {
-
-                            g->state = GAME_STATE_FORBIDDEN;
-                            g->winner = WHITE_STONE;
-                            return true;
-
-                        }      
-                              
-                    } else if ( neg_count == OVERLINE || ( half_open_four_count + open_four_count >= MAX_VIOLATIONS ) ) {
-
-                        g->state = GAME_STATE_FORBIDDEN;
-                        g->winner = WHITE_STONE;
-                        return true;
-
-                    } else if ( neg_count == WIN_CONDITION && neg_spaces == INITIALIZE && grid[i + k + ONE_SPACE_OUT][j - k - ONE_SPACE_OUT] != BLACK_STONE ) {
-                        g->state = GAME_STATE_FINISHED;
-                        g->winner = BLACK_STONE;
-                        return true;
-                    }
-
-                } else {
-                    break;
-                }
-            }
-
-        }
-    }
+    if ( result == RULES_FIVE ) {
+        g->state = GAME_STATE_FINISHED;
+        g->winner = BLACK_STONE;
+        return true;
+    } else if ( result != RULES_NONE ) {
+        g->state = GAME_STATE_FORBIDDEN;
+        g->winner = WHITE_STONE;
+        return true;
+    }
 
     // Check if the board is full
     if ( board_is_full( g->board ) ) {
@@ -1841,24 +762,28 @@ static bool game_renju_black( game* g, unsigned char x, unsigned char y ) {
 
 
 bool game_place_stone( game* g, unsigned char x, unsigned char y ) {
-    unsigned char ( *grid )[g->board->size] = ( unsigned char ( * )[g->board->size] ) g->board->grid;
 
-    if ( grid[y][x] != EMPTY_INTERSECTION ) {
-        printf( "There is already a stone at the coordinate you entered, please try again.\n" );
+    if ( x >= g->board->size || y >= g->board->size || board_get( g->board, x, y ) != EMPTY_INTERSECTION ) {
         return false;
     }
 
     if ( g->moves_count >= g->moves_capacity ) {
-        g->moves_capacity *= CAPACITY_INCREASE;
-        g->moves = ( move * ) realloc( g->moves, g->moves_capacity * sizeof( move ) );
-        if ( !g->moves ) {
-            exit( NULL_POINTER_ERR );
+
+        // Storing the grown moves array, the old one stays valid if realloc fails
+        move* moves = ( move * ) realloc( g->moves, g->moves_capacity * CAPACITY_INCREASE * sizeof( move ) );
+
+        if ( !moves ) {
+            return false;
         }
+        g->moves = moves;
+        g->moves_capacity *= CAPACITY_INCREASE;
     }
 
     g->moves[g->moves_count].x = x;
     g->moves[g->moves_count].y = y;
     g->moves[g->moves_count].stone = g->stone;
+    g->moves[g->moves_count].state = g->state;
+    g->moves[g->moves_count].winner = g->winner;
     g->moves_count++;
 
     board_set( g->board, x, y, g->stone );
@@ -1878,8 +803,38 @@ bool game_place_stone( game* g, unsigned char x, unsigned char y ) {
         g->stone = ( g->stone == BLACK_STONE ) ? WHITE_STONE : BLACK_STONE;
     }
 
+    if ( g->journal ) {
+        journal_move( g->journal, x, y );
+
+        // The end of a game is worth a sync of its own
+        if ( g->state != GAME_STATE_PLAYING ) {
+            journal_sync( g->journal );
+        }
+    }
+
     return true;
 }
 
 
+bool game_unplace_stone( game* g ) {
+
+    if ( g->moves_count == INITIALIZE ) {
+        return false;
+    }
+
+    g->moves_count--;
+
+    // Storing the move being taken back
+    move* last = &g->moves[g->moves_count];
+
+    board_unset( g->board, last->x, last->y );
+    g->stone = last->stone;
+    g->state = last->state;
+    g->winner = last->winner;
 
+    if ( g->journal ) {
+        journal_undo( g->journal );
+    }
+
+    return true;
+}
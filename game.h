@@ -3,6 +3,7 @@
 #include "board.h"
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdio.h>
 
 #define GAME_FREESTYLE 0
 #define GAME_RENJU 1
@@ -24,48 +25,91 @@
 #define TWO_SPACE_OUT 2
 #define CAPACITY_INCREASE 2
 #define LONG_DEFAULT_STRING_LENGTH 100
+#define UNDO_COMMAND "undo"
+#define COMPUTER_BOTH ( BLACK_STONE | WHITE_STONE )
+#define BATCH_CHUNK 65536
+#define BATCH_DEFAULT_SIZE 15
+#define REPLAY_ENTRY_LENGTH 16
+#define REPLAY_CHECKPOINT_INTERVAL 16
 
+/**
+ * A move as kept on the game's move stack. state and winner hold the game state and winner
+ * from before the move, so game_unplace_stone() can restore them.
+ */
 typedef struct {
     unsigned char x;
     unsigned char y;
     unsigned char stone;
+    unsigned char state;
+    unsigned char winner;
 } move;
 
+struct journal;
+
+/**
+ * A game. computer selects the stones played by the engine instead of read from the terminal:
+ * EMPTY_INTERSECTION for none, BLACK_STONE, WHITE_STONE or COMPUTER_BOTH, tested with computer & stone.
+ * journal, if not NULL, gets every move game_place_stone() places and every move game_unplace_stone() takes back,
+ * and belongs to the game.
+ */
 typedef struct {
     board* board;
     unsigned char type;
     unsigned char stone;
     unsigned char state;
     unsigned char winner;
+    unsigned char computer;
+    struct journal* journal;
     move* moves;
     size_t moves_count;
     size_t moves_capacity;
 } game;
 
+/**
+ * A position inside a recorded game, for random-access replay. board holds the position after the first position moves of game.
+ * checkpoints[k] holds the position after k * interval moves, so any position is rebuilt with board_copy()
+ * and fewer than interval calls to board_set(). The cursor never changes game or its board.
+ */
+typedef struct {
+    game* game;
+    board* board;
+    size_t position;
+    size_t interval;
+    board** checkpoints;
+    size_t checkpoints_count;
+} game_cursor;
+
 /**
  * This function creates and returns a new dynamically allocated game struct of the specified type game_type with all fields initialized.
  * The board should be created with function board_create(); type should be set to game_type;
  * stone should be set to BLACK_STONE; state should be set to GAME_STATE_PLAYING; winner should be set to EMPTY_INTERSECTION;
+ * computer should be set to EMPTY_INTERSECTION so both sides are played from the terminal; journal should be set to NULL;
  * moves should be dynamically allocated, it should have an initial capacity to hold 16 moves, also, initialize moves_count and moves_capacity accordingly.
+ * If the board can't be created or memory runs out, return NULL instead.
  * @param board_size The size of the board to be created.
  * @param game_type The type of the game (GAME_FREESTYLE or GAME_RENJU).
- * @return game* A pointer to the newly created game struct.
+ * @return game* A pointer to the newly created game struct, or NULL.
  */
 game* game_create(unsigned char board_size, unsigned char game_type);
 
 /**
  * This function frees the memory of a dynamically allocated game struct.
- * You should also free the memory of its dynamically allocated fields, note that board should be freed by function board_delete().
- * If g is NULL, exit with the code NULL_POINTER_ERR as defined in error-codes.h.
+ * You should also free the memory of its dynamically allocated fields, note that board should be freed by function board_delete()
+ * and a journal closed by journal_close().
+ * If g is NULL, return NULL_POINTER_ERR as defined in error-codes.h, otherwise return SUCCESS.
  * @param g A pointer to the game struct to be deleted.
+ * @return unsigned char SUCCESS, or NULL_POINTER_ERR.
  */
-void game_delete(game* g);
+unsigned char game_delete(game* g);
 
 /**
  * This function controls what happens in the game at each turn. If the state of game g isn't GAME_STATE_PLAYING,
  * return false immediately. Otherwise, prompt the player to enter a move, if the move entered is badly-formatted or out of board boundary,
  * re-prompt and retry until a valid one is entered; if an EOF is entered in the process, stop the game and prompt accordingly.
  * Once a valid move is input, actuate the move by calling game_place_stone() and return true.
+ * Entering UNDO_COMMAND alone instead of a move takes back the last move with game_unplace_stone() and returns true;
+ * against the computer, its moves since the player's last one are taken back too, so it is the player's turn again.
+ * If the side to move is played by the computer, the move is chosen by engine_search() with the default limits instead of read.
  * @param g A pointer to the game struct.
  * @return bool true if the game continues, false if it stops.
  */
@@ -80,12 +124,14 @@ void game_loop(game* g);
 
 /**
  * This function restarts the game loop for a saved game.
- * If the state of g is not GAME_STATE_STOPPED, exit with the code RESUME_ERR as defined in error-codes.h.
+ * If the state of g is not GAME_STATE_STOPPED, return RESUME_ERR as defined in error-codes.h.
  * Also, before you call game_resume(), you should check the type of g, if it's against the type of the executable (gomoku or renju),
- * you should exit with RESUME_ERR as well. Otherwise, set state of g to GAME_STATE_PLAYING, and call game_loop().
+ * you should exit with RESUME_ERR as well. Otherwise, set up the board from the moves of g, which an import leaves empty,
+ * give the turn to the side after the last move, set state of g to GAME_STATE_PLAYING, call game_loop() and return SUCCESS.
  * @param g A pointer to the game struct.
+ * @return unsigned char SUCCESS, or RESUME_ERR.
  */
-void game_resume(game* g);
+unsigned char game_resume(game* g);
 
 /**
  * This function replays a saved game. It creates a new game struct, 
@@ -96,13 +142,98 @@ void game_resume(game* g);
 void game_replay(game* g);
 
 /**
- * This function checks for winning conditions in freestyle Gomoku.
+ * This function prints the position of game g after the first position moves the way game_replay() prints it at that move:
+ * the board, the conclusion of the game if position is the last move, and the moves list up to position.
+ * The position is found with a game_cursor, and the board of g is left untouched.
+ * If g is NULL, return NULL_POINTER_ERR; if position is more than the number of moves, return ARGUMENT_ERR;
+ * if memory runs out, return MEMORY_ERR. Otherwise return SUCCESS.
+ * @param g A pointer to the game struct.
+ * @param position The number of moves to show played.
+ * @return unsigned char SUCCESS, NULL_POINTER_ERR, ARGUMENT_ERR or MEMORY_ERR.
+ */
+unsigned char game_replay_at(game* g, size_t position);
+
+/**
+ * This function creates a cursor at the start of game g, with a board of its own and a checkpoint every interval moves
+ * (REPLAY_CHECKPOINT_INTERVAL if interval is 0). The checkpoints are taken in one pass over the moves of g.
+ * If g is NULL or memory runs out, return NULL instead.
+ * @param g A pointer to the game struct, which must outlive the cursor.
+ * @param interval The number of moves between two checkpoints.
+ * @return game_cursor* A pointer to the newly created cursor, or NULL.
+ */
+game_cursor* game_cursor_create(game* g, size_t interval);
+
+/**
+ * This function frees the memory of a cursor, its board and its checkpoints, but not its game.
+ * If c is NULL, return NULL_POINTER_ERR as defined in error-codes.h, otherwise return SUCCESS.
+ * @param c A pointer to the cursor to be deleted.
+ * @return unsigned char SUCCESS, or NULL_POINTER_ERR.
+ */
+unsigned char game_cursor_delete(game_cursor* c);
+
+/**
+ * This function moves cursor c to the position after the first position moves of its game.
+ * Going forward applies the moves from the current position, or from the nearest checkpoint if that is closer;
+ * going back always restarts from the nearest checkpoint at or before position.
+ * If position is more than the number of moves, nothing changes and it returns false.
+ * @param c A pointer to the cursor.
+ * @param position The number of moves to have played.
+ * @return bool true if the cursor is at position, false otherwise.
+ */
+bool game_cursor_seek(game_cursor* c, size_t position);
+
+/**
+ * This function moves cursor c one move forward, or one move back if forward is false.
+ * @param c A pointer to the cursor.
+ * @param forward true to step forward, false to step back.
+ * @return bool true if the cursor moved, false if it is already at the end (or the start).
+ */
+bool game_cursor_step(game_cursor* c, bool forward);
+
+/**
+ * This function plays many games of type game_type from the move stream in without prompting or printing the board.
+ * Every line of in is one game: an optional board size (15, 17 or 19, BATCH_DEFAULT_SIZE if left out) followed by
+ * whitespace-separated "letter + number" moves, black first. For every game one result record is written to out:
+ * "<game> <moves> <state> <winner>" with the numbering of the .gmk header fields, where a game that runs out of moves
+ * is GAME_STATE_STOPPED, or "<game> <moves> invalid <move>" if a move is badly-formatted, occupied, or comes after the game ended.
+ * Games are numbered from 1 and <moves> counts the moves played.
+ * @param in The move stream.
+ * @param out The stream to write the result records to.
+ * @param game_type The type of the games (GAME_FREESTYLE or GAME_RENJU).
+ * @return unsigned char SUCCESS, FILE_INPUT_ERR if in can't be read, or MEMORY_ERR if a game can't be created.
+ */
+unsigned char game_batch(FILE* in, FILE* out, unsigned char game_type);
+
+/**
+ * This function plays the moves of g again with game_place_stone() on a new game of the same type and size,
+ * and stores the state and winner the rules give in state and winner, GAME_STATE_STOPPED if the game is still going after the last move.
+ * played is set to the number of moves that could be played: a move that is off the board, occupied, or comes after the game ended stops the replay there.
+ * The stored fields of g aren't trusted or changed.
+ * @param g A pointer to the game struct to check.
+ * @param state A pointer to store the recomputed state.
+ * @param winner A pointer to store the recomputed winner.
+ * @param played A pointer to store the number of moves played.
+ * @return bool true if every move was played and the recomputed state and winner match those stored in g, otherwise false.
+ */
+bool game_check(game* g, unsigned char* state, unsigned char* winner, size_t* played);
+
+/**
+ * This function places a stone of the side to move at x, y, records it on the move stack, and checks the result with the rules of the game type.
  * If five or more consecutive stones are found in any direction (horizontal, vertical, main diagonals, secondary diagonals), 
- * it updates the game state and winner and returns true. If the board is full, it updates the game state to finished and returns false. Otherwise, returns true.
+ * it updates the game state and winner; Renju black is held to exactly five and loses on a forbidden move. Unless the board is full, the side to move passes to the other player.
+ * If x, y is off the board or already occupied, or the move stack can't grow, nothing changes and it returns false; it never prints or exits.
  * @param g A pointer to the game struct.
- * @param x The x-coordinate of the last move.
- * @param y The y-coordinate of the last move.
- * @return bool true if the game continues, false if it stops.
+ * @param x The x-coordinate of the move.
+ * @param y The y-coordinate of the move.
+ * @return bool true if the stone was placed, false otherwise.
  */
 bool game_place_stone(game* g, unsigned char x, unsigned char y);
+
+/**
+ * This function takes back the last move of game g in constant time: it pops the move stack,
+ * removes the stone from the board, and restores the side to move, state and winner from before the move.
+ * @param g A pointer to the game struct.
+ * @return bool true if a move was taken back, false if there are no moves.
+ */
+bool game_unplace_stone(game* g);
 #endif
@@ -0,0 +1,362 @@
+/**
+* @file gmkcheck.c
+* @author Sadia Ahmed (sahmed23)
+* This file checks saved games in bulk
+* every game is played again under its rules on a pool of threads
+* and the stored result is compared with the one the rules give
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "io.h"
+#include "board.h"
+#include "game.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define GMKCHECK_CHUNK 64
+#define GMKCHECK_MAX_THREADS 256
+#define GMKCHECK_EXTENSION ".gmk"
+
+/**
+ * The outcome of checking one file. status is the game_import() status; if it is SUCCESS,
+ * ok, state, winner and played are what game_check() gave, and stored_state and stored_winner are the fields of the file.
+ */
+typedef struct {
+    unsigned char status;
+    bool ok;
+    unsigned char state;
+    unsigned char winner;
+    unsigned char stored_state;
+    unsigned char stored_winner;
+    size_t played;
+    size_t moves_count;
+} gmkcheck_result;
+
+/**
+ * The work shared by the threads: the files, one result per file, and the index of the next file nobody has taken yet.
+ * Threads take GMKCHECK_CHUNK files at a time, so the lock is taken once per chunk rather than once per file.
+ */
+typedef struct {
+    char** paths;
+    gmkcheck_result* results;
+    size_t count;
+    size_t next;
+    pthread_mutex_t lock;
+} gmkcheck_pool;
+
+/**
+ * The list of files to check, grown as directories are walked.
+ */
+typedef struct {
+    char** paths;
+    size_t count;
+    size_t capacity;
+} gmkcheck_list;
+
+/**
+ * Appends a copy of path to the list.
+ * @param list A pointer to the list.
+ * @param path The path to append.
+ * @return bool true if it was appended, false if memory runs out.
+ */
+static bool gmkcheck_add( gmkcheck_list* list, const char* path )
+{
+    if ( list->count >= list->capacity ) {
+
+        // Storing the new capacity of the list
+        size_t capacity = list->capacity ? list->capacity * CAPACITY_INCREASE : GAME_CAPACITY;
+
+        // Storing the grown array, the old one stays valid if realloc fails
+        char** paths = ( char** ) realloc( list->paths, capacity * sizeof( char* ) );
+
+        if ( !paths ) {
+            return false;
+        }
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+
+    list->paths[list->count] = strdup( path );
+
+    return list->paths[list->count++] != NULL;
+}
+
+/**
+ * Adds path to the list: a directory is walked recursively for files ending in GMKCHECK_EXTENSION,
+ * anything else is added as it is, so a bad path shows up as an import error. Symbolic links to directories
+ * found in the walk aren't followed, so a link loop can't recurse forever.
+ * @param list A pointer to the list.
+ * @param path The file or directory.
+ * @return bool true on success, false if memory runs out.
+ */
+static bool gmkcheck_collect( gmkcheck_list* list, const char* path )
+{
+    // Storing the status of path
+    struct stat st;
+
+    if ( stat( path, &st ) != 0 || !S_ISDIR( st.st_mode ) ) {
+        return gmkcheck_add( list, path );
+    }
+
+    // Opening the directory
+    DIR* dir = opendir( path );
+
+    if ( !dir ) {
+        return gmkcheck_add( list, path );
+    }
+
+    // Storing the current directory entry
+    struct dirent* entry;
+
+    // Storing whether memory ran out
+    bool ok = true;
+
+    while ( ok && ( entry = readdir( dir ) ) != NULL ) {
+
+        // Storing the length of the entry name
+        size_t length = strlen( entry->d_name );
+
+        if ( strcmp( entry->d_name, "." ) == 0 || strcmp( entry->d_name, ".." ) == 0 ) {
+            continue;
+        }
+
+        // Storing the path of the entry
+        char* child = malloc( strlen( path ) + length + 2 );
+
+        if ( !child ) {
+            ok = false;
+            break;
+        }
+        sprintf( child, "%s/%s", path, entry->d_name );
+
+        if ( lstat( child, &st ) == 0 && S_ISDIR( st.st_mode ) ) {
+            ok = gmkcheck_collect( list, child );
+        } else if ( length >= strlen( GMKCHECK_EXTENSION ) &&
+                    strcmp( entry->d_name + length - strlen( GMKCHECK_EXTENSION ), GMKCHECK_EXTENSION ) == 0 ) {
+            ok = gmkcheck_add( list, child );
+        }
+
+        free( child );
+    }
+
+    closedir( dir );
+
+    return ok;
+}
+
+/**
+ * Orders paths for qsort(), so the report doesn't depend on the order of directory entries.
+ * @param a A pointer to the first path.
+ * @param b A pointer to the second path.
+ * @return int The strcmp() of the two paths.
+ */
+static int gmkcheck_compare( const void* a, const void* b )
+{
+    return strcmp( *( char* const* ) a, *( char* const* ) b );
+}
+
+/**
+ * Imports and checks one file.
+ * @param path The path to the file.
+ * @param result A pointer to store the outcome.
+ */
+static void gmkcheck_file( const char* path, gmkcheck_result* result )
+{
+    game* Game = NULL;
+
+    result->status = game_import( path, &Game );
+
+    if ( result->status != SUCCESS ) {
+        return;
+    }
+
+    result->ok = game_check( Game, &result->state, &result->winner, &result->played );
+    result->stored_state = Game->state;
+    result->stored_winner = Game->winner;
+    result->moves_count = Game->moves_count;
+
+    game_delete( Game );
+}
+
+/**
+ * The body of every thread of the pool: takes chunks of files until none are left.
+ * @param arg A pointer to the gmkcheck_pool.
+ * @return void* NULL.
+ */
+static void* gmkcheck_worker( void* arg )
+{
+    gmkcheck_pool* pool = ( gmkcheck_pool* ) arg;
+
+    for ( ;; ) {
+
+        pthread_mutex_lock( &pool->lock );
+
+        // Storing the chunk taken by this thread
+        size_t first = pool->next;
+        size_t last = first + GMKCHECK_CHUNK < pool->count ? first + GMKCHECK_CHUNK : pool->count;
+
+        pool->next = last;
+        pthread_mutex_unlock( &pool->lock );
+
+        if ( first >= last ) {
+            return NULL;
+        }
+
+        for ( size_t i = first; i < last; i++ ) {
+            gmkcheck_file( pool->paths[i], &pool->results[i] );
+        }
+    }
+}
+
+/**
+ * Prints the usage of gmkcheck.
+ * @param name The name of the executable.
+ */
+static void gmkcheck_usage( const char* name )
+{
+    printf( "usage: %s [-j <threads>] <saved-match.gmk | directory>...\n", name );
+}
+
+/**
+ * Checks saved games in bulk. Every file given, and every .gmk file under every directory given, is imported and played again
+ * with game_check() on a pool of threads (one per online processor unless -j says otherwise). A line is printed for every file
+ * that can't be imported, has a move that can't be played, or whose stored state and winner differ from the recomputed ones,
+ * followed by a summary with the throughput in games per second.
+ * @param argc the number of terminal arguments defined by user
+ * @param the array of arguments themselves
+ * @return SUCCESS if every game checks out, EXIT_FAILURE if any doesn't, or the error status
+ */
+int main( int argc, char *argv[] )
+{
+
+    // Storing the length of the filename for comparison
+    size_t str_length_one = strlen( argv[0] );
+
+    // Storing the part of the file name to compare to
+    char src_path[DEFAULT_STRING_LENGTH] = "gmkcheck";
+
+    // Storing the length of the file name to compare to
+    size_t str_length_two = strlen( src_path );
+
+    if ( str_length_one < str_length_two || strncmp( argv[0] + str_length_one - str_length_two, src_path, str_length_two ) != 0 ) {
+        exit( FILE_INPUT_ERR );
+    }
+
+    // Storing the number of threads, one per processor by default
+    long threads = sysconf( _SC_NPROCESSORS_ONLN );
+
+    // Storing the files to check
+    gmkcheck_list list = { NULL, INITIALIZE, INITIALIZE };
+
+    for ( int i = 1; i < argc; i++ ) {
+
+        if ( strcmp( "-j", argv[i] ) == 0 ) {
+
+            // Storing the end of the thread count
+            char* end = NULL;
+
+            threads = i + 1 < argc ? strtol( argv[++i], &end, 10 ) : INITIALIZE;
+
+            if ( !end || *end != '\0' || threads < 1 || threads > GMKCHECK_MAX_THREADS ) {
+                gmkcheck_usage( argv[0] );
+                exit( ARGUMENT_ERR );
+            }
+        } else if ( !gmkcheck_collect( &list, argv[i] ) ) {
+            exit( MEMORY_ERR );
+        }
+    }
+
+    if ( list.count == INITIALIZE && argc < 2 ) {
+        gmkcheck_usage( argv[0] );
+        exit( ARGUMENT_ERR );
+    }
+
+    if ( threads < 1 ) {
+        threads = 1;
+    }
+
+    qsort( list.paths, list.count, sizeof( char* ), gmkcheck_compare );
+
+    // Storing the work shared by the threads
+    gmkcheck_pool pool = { .paths = list.paths, .results = calloc( list.count + 1, sizeof( gmkcheck_result ) ),
+                           .count = list.count, .next = INITIALIZE };
+
+    // Storing the threads of the pool
+    pthread_t* workers = malloc( threads * sizeof( pthread_t ) );
+
+    if ( !pool.results || !workers ) {
+        exit( MEMORY_ERR );
+    }
+
+    pthread_mutex_init( &pool.lock, NULL );
+
+    // Storing the time the checks started
+    struct timespec start;
+    struct timespec stop;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+
+    // Storing the number of threads actually started, the caller checks alone if none could be
+    long started = INITIALIZE;
+
+    while ( started < threads && pthread_create( &workers[started], NULL, gmkcheck_worker, &pool ) == 0 ) {
+        started++;
+    }
+
+    if ( started == INITIALIZE ) {
+        gmkcheck_worker( &pool );
+    }
+
+    for ( long i = INITIALIZE; i < started; i++ ) {
+        pthread_join( workers[i], NULL );
+    }
+
+    clock_gettime( CLOCK_MONOTONIC, &stop );
+
+    pthread_mutex_destroy( &pool.lock );
+
+    // Storing the number of files that can't be imported and of games that don't check out
+    size_t unreadable = INITIALIZE;
+    size_t mismatches = INITIALIZE;
+
+    for ( size_t i = INITIALIZE; i < list.count; i++ ) {
+
+        gmkcheck_result* result = &pool.results[i];
+
+        if ( result->status != SUCCESS ) {
+            printf( "%s: can't be imported (error %d)\n", list.paths[i], result->status );
+            unreadable++;
+        } else if ( result->played < result->moves_count ) {
+            printf( "%s: move %zu of %zu can't be played\n", list.paths[i], result->played + 1, result->moves_count );
+            mismatches++;
+        } else if ( !result->ok ) {
+            printf( "%s: stored state %d winner %d, rules give state %d winner %d\n", list.paths[i],
+                    result->stored_state, result->stored_winner, result->state, result->winner );
+            mismatches++;
+        }
+
+        free( list.paths[i] );
+    }
+
+    // Storing the time the checks took in seconds
+    double seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+    printf( "%zu games, %zu mismatches, %zu unreadable, %ld threads, %.0f games/s\n", list.count, mismatches, unreadable,
+            started ? started : 1, seconds > 0 ? list.count / seconds : 0.0 );
+
+    free( list.paths );
+    free( pool.results );
+    free( workers );
+
+    return mismatches || unreadable ? EXIT_FAILURE : SUCCESS;
+}
@@ -7,6 +7,7 @@
 
 
 #include "io.h"
+#include "journal.h"
 #include "board.h"
 #include "game.h"
 #include "error-codes.h"
@@ -42,8 +43,85 @@ int main( int argc, char *argv[] )
 
     game * Game = NULL;
 
+    // Storing which stones the computer plays
+    unsigned char computer = EMPTY_INTERSECTION;
+
+    // Storing the format of the saved game
+    unsigned char format = GMK_FORMAT_TEXT;
+
+    // Storing the path of the move journal, if any
+    const char* journal_path = NULL;
+
+    for ( int i = 1; i < argc; i++ ) {
+
+        if ( strcmp( "--batch", argv[i] ) == 0 ) {
+
+            // Storing the move stream, stdin unless a file is given
+            FILE* in = stdin;
+
+            if ( i + 1 < argc && strcmp( "-", argv[i + 1] ) != 0 ) {
+                in = fopen( argv[i + 1], "r" );
+                if ( !in ) {
+                    exit( FILE_INPUT_ERR );
+                }
+            }
+
+            // Storing the status of the batch
+            unsigned char status = game_batch( in, stdout, GAME_FREESTYLE );
+
+            if ( in != stdin ) {
+                fclose( in );
+            }
+
+            if ( status != SUCCESS ) {
+                exit( status );
+            }
+
+            return EXIT_SUCCESS;
+        }
+
+        if ( strcmp( "-f", argv[i] ) == 0 ) {
+            if ( i + 1 < argc && strcmp( "text", argv[i + 1] ) == 0 ) {
+                format = GMK_FORMAT_TEXT;
+            } else if ( i + 1 < argc && strcmp( "binary", argv[i + 1] ) == 0 ) {
+                format = GMK_FORMAT_BINARY;
+            } else {
+                printf( "usage: ./%s ", src_path );
+                printf( "[-r <unfinished-match.gmk>] [-o <saved-match.gmk>] [-b <15|17|19>] [-c <black|white|both>] [-f <text|binary>] [-j <journal>] [--batch [<moves-file>]]\n" );
+                printf( "       -r and -b conflicts with each other\n" );
+                exit( ARGUMENT_ERR );
+            }
+            continue;
+        }
+
+        if ( strcmp( "-j", argv[i] ) == 0 && i + 1 < argc ) {
+            journal_path = argv[i + 1];
+            continue;
+        }
+
+        if ( strcmp( "-c", argv[i] ) != 0 ) {
+            continue;
+        }
+
+        if ( i + 1 < argc && strcmp( "black", argv[i + 1] ) == 0 ) {
+            computer = BLACK_STONE;
+        } else if ( i + 1 < argc && strcmp( "white", argv[i + 1] ) == 0 ) {
+            computer = WHITE_STONE;
+        } else if ( i + 1 < argc && strcmp( "both", argv[i + 1] ) == 0 ) {
+            computer = COMPUTER_BOTH;
+        } else {
+            printf( "usage: ./%s ", src_path );
+            printf( "[-r <unfinished-match.gmk>] [-o <saved-match.gmk>] [-b <15|17|19>] [-c <black|white|both>] [-f <text|binary>] [-j <journal>] [--batch [<moves-file>]]\n" );
+            printf( "       -r and -b conflicts with each other\n" );
+            exit( ARGUMENT_ERR );
+        }
+    }
+
     if ( argc == 1 ) {
         Game = game_create( 15, GAME_FREESTYLE );
+        if ( !Game ) {
+            exit( MEMORY_ERR );
+        }
         game_loop( Game );
         return EXIT_SUCCESS;
     }
@@ -92,7 +170,7 @@ int main( int argc, char *argv[] )
 
                 if ( size_param == 0 ) {
                     printf( "usage: ./%s ", src_path );
-                    printf( "[-r <unfinished-match.gmk>] [-o <saved-match.gmk>] [-b <15|17|19>]\n" );
+                    printf( "[-r <unfinished-match.gmk>] [-o <saved-match.gmk>] [-b <15|17|19>] [-c <black|white|both>] [-f <text|binary>] [-j <journal>] [--batch [<moves-file>]]\n" );
                     printf( "       -r and -b conflicts with each other\n" );
                     exit( ARGUMENT_ERR );
                 }
@@ -105,6 +183,13 @@ int main( int argc, char *argv[] )
                 unsigned char size = ( unsigned char ) size_param;
 
                 Game = game_create( size, GAME_FREESTYLE );
+                if ( !Game ) {
+                    exit( MEMORY_ERR );
+                }
+                Game->computer = computer;
+                if ( journal_path && journal_open( journal_path, Game, &Game->journal ) != SUCCESS ) {
+                    exit( FILE_OUTPUT_ERR );
+                }
                 game_loop( Game );
                 b_flag = true;
 
@@ -115,13 +200,24 @@ int main( int argc, char *argv[] )
                     break;
                 }
 
-                Game = game_import( argv[i + 1] );
+                // Storing the status of the import
+                unsigned char status = game_import( argv[i + 1], &Game );
+
+                if ( status != SUCCESS ) {
+                    exit( status );
+                }
 
                 if ( Game->type != GAME_FREESTYLE && Game->type != GAME_RENJU ) {
                     exit( RESUME_ERR );
                 } 
 
-                game_resume( ( game * ) Game );
+                Game->computer = computer;
+                if ( journal_path && journal_open( journal_path, Game, &Game->journal ) != SUCCESS ) {
+                    exit( FILE_OUTPUT_ERR );
+                }
+                if ( game_resume( ( game * ) Game ) != SUCCESS ) {
+                    exit( RESUME_ERR );
+                }
                 r_flag = true;
             } 
 
@@ -129,24 +225,45 @@ int main( int argc, char *argv[] )
 
         if ( r_flag && b_flag ) {
             printf( "usage: .//%s ", src_path );
-            printf( "[-r <unfinished-match.gmk>] [-o <saved-match.gmk>] [-b <15|17|19>]\n" );
+            printf( "[-r <unfinished-match.gmk>] [-o <saved-match.gmk>] [-b <15|17|19>] [-c <black|white|both>] [-f <text|binary>] [-j <journal>] [--batch [<moves-file>]]\n" );
             printf( "       -r and -b conflicts with each other\n" );
 
             exit( ARGUMENT_ERR );
         }
 
-        if ( o_flag && !r_flag && !b_flag ) {
+        if ( !r_flag && !b_flag ) {
             Game = game_create( 15, GAME_FREESTYLE );
+            if ( !Game ) {
+                exit( MEMORY_ERR );
+            }
+            Game->computer = computer;
+            if ( journal_path && journal_open( journal_path, Game, &Game->journal ) != SUCCESS ) {
+                exit( FILE_OUTPUT_ERR );
+            }
             game_loop( Game );
-            game_export( ( game * ) Game, output_path );
-        } else if ( o_flag && ( r_flag || b_flag ) ) {
-            game_export( ( game * ) Game, output_path );
+        }
+
+        // Every move is already in the journal, closing it syncs the last of them
+        if ( Game->journal ) {
+
+            // Storing the status of the journal
+            unsigned char status = journal_close( Game->journal );
+
+            Game->journal = NULL;
+            if ( status != SUCCESS ) {
+                exit( FILE_OUTPUT_ERR );
+            }
+        }
+
+        if ( o_flag ) {
+            if ( game_export_format( ( game * ) Game, output_path, format ) != SUCCESS ) {
+                exit( FILE_OUTPUT_ERR );
+            }
         }
 
 
     }
 
-    board_delete( Game->board );
     game_delete( ( game * ) Game );
 
     return EXIT_SUCCESS;
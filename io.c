@@ -5,8 +5,10 @@
 * and also exports the game data when the game is stopped or finished
 */
 
+#define _POSIX_C_SOURCE 200809L
 
 #include "io.h"
+#include "journal.h"
 #include "board.h"
 #include "game.h"
 #include "error-codes.h"
@@ -14,155 +16,415 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-game* game_import( const char* path ) 
+/**
+ * Returns true if the header fields read from a .gmk file are valid, otherwise stores the error code in error.
+ * @param size The board size.
+ * @param type The game type.
+ * @param state The game state.
+ * @param winner The winner.
+ * @param error A pointer to store BOARD_SIZE_ERR or FILE_INPUT_ERR.
+ * @return bool true if the header is valid.
+ */
+static bool game_header_valid( int size, int type, int state, int winner, unsigned char* error )
 {
+    if ( size != 15 && size != 17 && size != 19 ) {
+        *error = BOARD_SIZE_ERR;
+        return false;
+    }
+
+    if ( ( type != GAME_FREESTYLE && type != GAME_RENJU ) ||
+         ( state != GAME_STATE_FORBIDDEN && state != GAME_STATE_FINISHED && state != GAME_STATE_STOPPED ) ||
+         ( winner != BLACK_STONE && winner != WHITE_STONE && winner != EMPTY_INTERSECTION ) ) {
+        *error = FILE_INPUT_ERR;
+        return false;
+    }
 
-    // Reading in the file
-    FILE* fp = fopen( path, "r" );
+    return true;
+}
+
+/**
+ * Creates the game of an imported file with its header fields and room for exactly capacity moves,
+ * so the moves array is allocated once.
+ * @param size The board size.
+ * @param type The game type.
+ * @param state The game state.
+ * @param winner The winner.
+ * @param capacity The number of moves to make room for.
+ * @return game* A pointer to the new game struct, or NULL if memory runs out.
+ */
+static game* game_import_create( int size, int type, int state, int winner, size_t capacity )
+{
+    game *Game = game_create( size, type );
 
-    if ( !fp ) {
-        exit( FILE_INPUT_ERR );
+    if ( !Game ) {
+        return NULL;
     }
-    
-    // Storing in the magic number at beginning to compare
-    char magic_num[3] = {};
 
-    if ( fscanf( fp, "%2s", magic_num ) != 1 || strcmp( magic_num, "GA" ) != 0) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );
+    Game->state = state;
+    Game->winner = winner;
+
+    if ( capacity > Game->moves_capacity ) {
+        free( Game->moves );
+        Game->moves_capacity = capacity;
+        Game->moves = ( move * ) malloc( Game->moves_capacity * sizeof( move ) );
+        if ( !Game->moves ) {
+            game_delete( Game );
+            return NULL;
+        }
     }
 
-    // Storing the board size from file
-    int size = INITIALIZE;
+    return Game;
+}
 
-    if ( fscanf( fp, "%d", &size ) != 1 ) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );
+/**
+ * Fills in the stone and undo fields of the move at index i of an imported game, black moving first.
+ * @param m A pointer to the move.
+ * @param i The index of the move.
+ */
+static void game_import_move( move* m, size_t i )
+{
+    m->stone = ( i % 2 == 0 ) ? BLACK_STONE : WHITE_STONE;
+    m->state = GAME_STATE_PLAYING;
+    m->winner = EMPTY_INTERSECTION;
+}
+
+/**
+ * Imports a binary .gmk file from memory. The header is validated in place and the moves are decoded
+ * straight from the buffer into a moves array allocated once from the move count.
+ * @param data The contents of the file.
+ * @param length The length of the file.
+ * @param error A pointer to store the error code if the import fails.
+ * @return game* A pointer to the reconstructed game struct, or NULL on error.
+ */
+static game* game_import_binary( const unsigned char* data, size_t length, unsigned char* error )
+{
+    *error = FILE_INPUT_ERR;
+
+    if ( length < GMK_HEADER_SIZE || data[2] != GMK_BINARY_VERSION ) {
+        return NULL;
     }
 
-    // Casting the board size
-    unsigned char unsigned_size = ( unsigned char ) size;
+    // Storing the fields of the header
+    unsigned char size = data[3];
+    size_t count = ( size_t ) data[8] | ( size_t ) data[9] << 8 | ( size_t ) data[10] << 16 | ( size_t ) data[11] << 24;
 
-    if ( unsigned_size != 15 && unsigned_size != 17 && unsigned_size != 19 ) {
-        fclose( fp );
-        exit( BOARD_SIZE_ERR );
+    if ( !game_header_valid( size, data[4], data[5], data[6], error ) ) {
+        return NULL;
     }
-    
-    // Storing the game type from file
-    int type = INITIALIZE;
 
-    if ( fscanf( fp, "%d", &type ) != 1 ) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );
+    if ( count > ( size_t ) size * size || length < GMK_HEADER_SIZE + count * GMK_MOVE_SIZE ) {
+        *error = FILE_INPUT_ERR;
+        return NULL;
     }
 
-    // Casting the game type from file
-    unsigned char unsigned_type = ( unsigned char ) type;
+    game *Game = game_import_create( size, data[4], data[5], data[6], count );
 
-    if ( unsigned_type != GAME_FREESTYLE && unsigned_type != GAME_RENJU ) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );       
+    if ( !Game ) {
+        *error = MEMORY_ERR;
+        return NULL;
     }
 
-    game *Game = game_create( unsigned_size, unsigned_type );
-    
-    // Storing the game state from file
-    int state = INITIALIZE;
+    // Storing the first encoded move
+    const unsigned char* codes = data + GMK_HEADER_SIZE;
+
+    for ( size_t i = INITIALIZE; i < count; i++ ) {
+
+        // Storing the 16-bit code of the move
+        unsigned int code = codes[i * GMK_MOVE_SIZE] | codes[i * GMK_MOVE_SIZE + 1] << 8;
 
-    if ( fscanf( fp, "%d", &state) != 1 ) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );
+        Game->moves[i].x = code & GMK_COORD_MASK;
+        Game->moves[i].y = ( code >> GMK_COORD_BITS ) & GMK_COORD_MASK;
+        game_import_move( &Game->moves[i], i );
+
+        if ( Game->moves[i].x >= size || Game->moves[i].y >= size ) {
+            game_delete( Game );
+            return NULL;
+        }
     }
 
-    // Casting the game state from file
-    unsigned char unsigned_state = ( unsigned char ) state;
+    Game->moves_count = count;
+
+    return Game;
+}
 
-    if ( unsigned_state != GAME_STATE_FORBIDDEN && unsigned_state != GAME_STATE_FINISHED && unsigned_state != GAME_STATE_STOPPED ) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );       
-    } else {
-        Game->state = unsigned_state;
+/**
+ * Skips whitespace in a text buffer.
+ * @param p The current position.
+ * @param end The end of the buffer.
+ * @return const char* The first non-whitespace position, or end.
+ */
+static const char* game_skip_space( const char* p, const char* end )
+{
+    while ( p < end && ( *p == ' ' || *p == '\n' || *p == '\r' || *p == '\t' ) ) {
+        p++;
     }
+    return p;
+}
+
+/**
+ * Reads a non-negative decimal number from a text buffer after skipping whitespace.
+ * @param p A pointer to the current position, advanced past the number.
+ * @param end The end of the buffer.
+ * @param value A pointer to store the number.
+ * @return bool true if a number was read.
+ */
+static bool game_read_number( const char** p, const char* end, int* value )
+{
+    *p = game_skip_space( *p, end );
+
+    if ( *p >= end || **p < '0' || **p > '9' ) {
+        return false;
+    }
+
+    *value = INITIALIZE;
+    while ( *p < end && **p >= '0' && **p <= '9' && *value < LONG_DEFAULT_STRING_LENGTH * LONG_DEFAULT_STRING_LENGTH ) {
+        *value = *value * 10 + ( **p - '0' );
+        ( *p )++;
+    }
+
+    return true;
+}
+
+/**
+ * Imports a text .gmk file from memory without going through stdio.
+ * Every move takes at least three bytes, so the moves array is allocated once from the file length.
+ * @param data The contents of the file.
+ * @param length The length of the file.
+ * @param error A pointer to store the error code if the import fails.
+ * @return game* A pointer to the reconstructed game struct, or NULL on error.
+ */
+static game* game_import_text( const char* data, size_t length, unsigned char* error )
+{
+    *error = FILE_INPUT_ERR;
 
+    // Storing the current position and the end of the buffer
+    const char* p = game_skip_space( data, data + length );
+    const char* end = data + length;
+
+    if ( end - p < GMK_MAGIC_LENGTH || memcmp( p, GMK_TEXT_MAGIC, GMK_MAGIC_LENGTH ) != 0 ) {
+        return NULL;
+    }
+    p += GMK_MAGIC_LENGTH;
 
-    // Storing the winner from file
-    int winner = INITIALIZE;
+    // Storing the header fields
+    int size;
+    int type;
+    int state;
+    int winner;
 
-    if ( fscanf( fp, "%d", &winner ) != 1 ) {
-        fclose( fp );
-        exit( FILE_INPUT_ERR );
+    if ( !game_read_number( &p, end, &size ) || !game_read_number( &p, end, &type ) ||
+         !game_read_number( &p, end, &state ) || !game_read_number( &p, end, &winner ) ) {
+        return NULL;
     }
-    
-    // Casting the winner from file
-    unsigned char unsigned_winner = ( unsigned char ) winner;
-    
-    
-    if ( unsigned_winner != BLACK_STONE && unsigned_winner != WHITE_STONE && unsigned_winner != 0 ) {
-         fclose( fp );
-         exit( FILE_INPUT_ERR );       
-    } else {
-        Game->winner = unsigned_winner;
+
+    if ( !game_header_valid( size, type, state, winner, error ) ) {
+        return NULL;
     }
-    
-    // Storing the x coord of the move
-    char x_coord = INITIALIZE;
 
-    // Storing the y coord of the move
-    int y_coord = INITIALIZE;
+    game *Game = game_import_create( size, type, state, winner, ( end - p ) / 3 + 1 );
 
-    // Storing how many moves have been read in so far
-    int count = INITIALIZE;
+    if ( !Game ) {
+        *error = MEMORY_ERR;
+        return NULL;
+    }
 
-    while ( fscanf(fp, " %c%d", &x_coord, &y_coord ) != EOF ) {
-        if ( count >= Game->moves_capacity ) {
-            Game->moves_capacity *= CAPACITY_INCREASE;
-            Game->moves = realloc( Game->moves, Game->moves_capacity * sizeof( move ) );
-            if ( !Game->moves ) {
-                fclose( fp );
-                exit( FILE_INPUT_ERR );
-            }
-        }
+    // Storing the coordinates of every move, read in one pass
+    unsigned char* coords = malloc( 2 * Game->moves_capacity );
 
-        Game->moves[count].x = x_coord - 'A';
-        Game->moves[count].y = y_coord - 1;
-        
-        Game->moves[count].stone = ( count % 2 == 0 ) ? BLACK_STONE : WHITE_STONE;
+    // Storing how many moves were read and where the scan stopped
+    const char* stop = end;
+    size_t count = coords ? board_scan_coords( Game->board, p, end - p, coords, Game->moves_capacity, &stop ) : INITIALIZE;
 
-        count++;
+    if ( !coords || stop != end ) {
+        free( coords );
+        *error = coords ? FILE_INPUT_ERR : MEMORY_ERR;
+        game_delete( Game );
+        return NULL;
     }
 
-    Game->moves_count = count;
+    for ( size_t i = INITIALIZE; i < count; i++ ) {
+        Game->moves[i].x = coords[2 * i];
+        Game->moves[i].y = coords[2 * i + 1];
+        game_import_move( &Game->moves[i], i );
+    }
 
-    fclose( fp );
+    free( coords );
+    Game->moves_count = count;
 
     return Game;
 }
 
+unsigned char game_import( const char* path, game** g ) 
+{
+
+    *g = NULL;
+
+    // Opening the file
+    int fd = open( path, O_RDONLY );
+
+    if ( fd < 0 ) {
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the file status for its length
+    struct stat st;
+
+    if ( fstat( fd, &st ) != 0 || st.st_size < GMK_MAGIC_LENGTH ) {
+        close( fd );
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the length of the file
+    size_t length = st.st_size;
+
+    // Mapping the whole file, the descriptor isn't needed afterwards
+    void* data = mmap( NULL, length, PROT_READ, MAP_PRIVATE, fd, INITIALIZE );
+    close( fd );
+
+    if ( data == MAP_FAILED ) {
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the status of the import
+    unsigned char status = game_import_memory( data, length, g );
+
+    munmap( data, length );
+
+    return status;
+}
+
+unsigned char game_import_memory( const void* data, size_t length, game** g )
+{
+    *g = NULL;
+
+    if ( length < GMK_MAGIC_LENGTH ) {
+        return FILE_INPUT_ERR;
+    }
+
+    // Storing the error code if the import fails
+    unsigned char error = FILE_INPUT_ERR;
+
+    if ( memcmp( data, JOURNAL_MAGIC, GMK_MAGIC_LENGTH ) == 0 ) {
+        return journal_import( data, length, g );
+    }
+
+    *g = memcmp( data, GMK_BINARY_MAGIC, GMK_MAGIC_LENGTH ) == 0
+        ? game_import_binary( ( const unsigned char* ) data, length, &error )
+        : game_import_text( ( const char* ) data, length, &error );
 
-void game_export( game* g, const char* path ) 
+    return *g ? SUCCESS : error;
+}
+
+
+/**
+ * Writes game g to the open file fp in the binary format, header and moves in a single fwrite.
+ * @param g A pointer to the game struct to be exported.
+ * @param fp The file to write to.
+ * @return unsigned char SUCCESS, FILE_OUTPUT_ERR if the file can't be written, or MEMORY_ERR if memory runs out.
+ */
+static unsigned char game_export_binary( game* g, FILE* fp )
+{
+    // Storing the number of bytes to write
+    size_t length = GMK_HEADER_SIZE + g->moves_count * GMK_MOVE_SIZE;
+
+    // Storing the encoded file
+    unsigned char* buffer = malloc( length );
+
+    if ( !buffer ) {
+        return MEMORY_ERR;
+    }
+
+    memcpy( buffer, GMK_BINARY_MAGIC, GMK_MAGIC_LENGTH );
+    buffer[2] = GMK_BINARY_VERSION;
+    buffer[3] = g->board->size;
+    buffer[4] = g->type;
+    buffer[5] = g->state;
+    buffer[6] = g->winner;
+    buffer[7] = INITIALIZE;
+    buffer[8] = g->moves_count & 0xFF;
+    buffer[9] = ( g->moves_count >> 8 ) & 0xFF;
+    buffer[10] = ( g->moves_count >> 16 ) & 0xFF;
+    buffer[11] = ( g->moves_count >> 24 ) & 0xFF;
+
+    for ( size_t i = INITIALIZE; i < g->moves_count; i++ ) {
+
+        // Storing the 16-bit code of the move
+        unsigned int code = g->moves[i].x | g->moves[i].y << GMK_COORD_BITS;
+
+        buffer[GMK_HEADER_SIZE + i * GMK_MOVE_SIZE] = code & 0xFF;
+        buffer[GMK_HEADER_SIZE + i * GMK_MOVE_SIZE + 1] = code >> 8;
+    }
+
+    // Storing whether everything was written
+    bool written = fwrite( buffer, length, 1, fp ) == 1;
+
+    free( buffer );
+
+    return written ? SUCCESS : FILE_OUTPUT_ERR;
+}
+
+unsigned char game_export( game* g, const char* path ) 
+{
+    return game_export_format( g, path, GMK_FORMAT_TEXT );
+}
+
+unsigned char game_export_format( game* g, const char* path, unsigned char format ) 
 {
 
     // Creating a pointer to the file to write to
-    FILE* fp = fopen( path, "w" );
+    FILE* fp = fopen( path, format == GMK_FORMAT_BINARY ? "wb" : "w" );
 
     if ( fp == NULL ) {
-        exit( FILE_OUTPUT_ERR );
+        return FILE_OUTPUT_ERR;
+    }
+
+    // Storing the status of the write
+    unsigned char status = game_write( g, fp, format );
+
+    if ( fclose( fp ) != 0 ) {
+        return FILE_OUTPUT_ERR;
+    }
+
+    return status;
+}
+
+unsigned char game_write( game* g, FILE* fp, unsigned char format )
+{
+    if ( format == GMK_FORMAT_BINARY ) {
+        return game_export_binary( g, fp );
     }
 
     // Other info
-    fprintf( fp, "GA\n" );
+    fprintf( fp, GMK_TEXT_MAGIC "\n" );
     fprintf( fp, "%d\n", g->board->size );
     fprintf( fp, "%d\n", g->type );
     fprintf( fp, "%d\n", g->state );
     fprintf( fp, "%d\n", g->winner );
 
-    // Moves
-    for ( int i = INITIALIZE; i < g->moves_count; i++ ) {
-        fprintf( fp, "%c%d\n", 'A' + g->moves[i].x, g->moves[i].y + 1 );
+    // Moves, formatted into one buffer and written with a single fwrite
+    char* buffer = malloc( g->moves_count * ( BOARD_COORD_LENGTH + 1 ) + 1 );
+
+    // Storing the length of the formatted moves
+    size_t length = INITIALIZE;
+
+    if ( !buffer ) {
+        return MEMORY_ERR;
     }
 
-    fclose( fp );
-}
+    for ( size_t i = INITIALIZE; i < g->moves_count; i++ ) {
+        length += board_format_coord( g->moves[i].x, g->moves[i].y, buffer + length );
+        buffer[length++] = '\n';
+    }
+
+    // Storing whether everything was written
+    bool written = length == INITIALIZE || fwrite( buffer, length, 1, fp ) == 1;
 
+    free( buffer );
 
+    return !written || ferror( fp ) ? FILE_OUTPUT_ERR : SUCCESS;
+}
@@ -2,18 +2,75 @@
 #define _IO_H_
 #include "game.h"
 
+#define GMK_TEXT_MAGIC "GA"
+#define GMK_BINARY_MAGIC "GB"
+#define GMK_MAGIC_LENGTH 2
+#define GMK_BINARY_VERSION 2
+#define GMK_HEADER_SIZE 12
+#define GMK_MOVE_SIZE 2
+#define GMK_COORD_BITS 5
+#define GMK_COORD_MASK ( ( 1 << GMK_COORD_BITS ) - 1 )
+
+#define GMK_FORMAT_TEXT 1
+#define GMK_FORMAT_BINARY 2
+
+/*
+ * Binary .gmk (version 2) layout, all multi-byte fields little-endian:
+ *   0  "GB"          magic
+ *   2  version       GMK_BINARY_VERSION
+ *   3  size          15, 17 or 19
+ *   4  type          GAME_FREESTYLE or GAME_RENJU
+ *   5  state         GAME_STATE_FORBIDDEN, GAME_STATE_STOPPED or GAME_STATE_FINISHED
+ *   6  winner        EMPTY_INTERSECTION, BLACK_STONE or WHITE_STONE
+ *   7  reserved      0
+ *   8  moves_count   32-bit
+ *  12  moves         16-bit code per move, x | y << GMK_COORD_BITS, black moves first and alternating
+ */
+
 /**
- * Imports a saved game from a file and returns the reconstructed game struct.
+ * Imports a saved game from a file and stores the reconstructed game struct in g.
+ * The text format, the binary format and journals (recovered with journal_import()) are accepted, told apart by the magic number.
+ * The file is memory-mapped and parsed in place, and the moves array is allocated once, sized from the file.
  * @param path The path to the file to be imported.
- * @return game* A pointer to the reconstructed game struct.
- * If the file doesn't exist, can't be read, or doesn't follow the specified format, the function exits with FILE_INPUT_ERR.
+ * @param g A pointer to store the reconstructed game struct, set to NULL on error.
+ * @return unsigned char SUCCESS, or FILE_INPUT_ERR if the file doesn't exist, can't be read, or doesn't follow the specified format
+ * (BOARD_SIZE_ERR for an unsupported board size, MEMORY_ERR if memory runs out).
  */
-game* game_import(const char* path);
+unsigned char game_import(const char* path, game** g);
 
 /**
- * Exports the current game state to a file.
+ * Imports a saved game from the length bytes at data, in either format, the way game_import() imports a file.
+ * @param data The contents of a .gmk file.
+ * @param length The length of the contents.
+ * @param g A pointer to store the reconstructed game struct, set to NULL on error.
+ * @return unsigned char SUCCESS, or FILE_INPUT_ERR (BOARD_SIZE_ERR, MEMORY_ERR) as for game_import().
+ */
+unsigned char game_import_memory(const void* data, size_t length, game** g);
+
+/**
+ * Exports the current game state to a file in the text format.
  * @param g A pointer to the game struct to be exported.
  * @param path The path to the file where the game state will be exported.
+ * @return unsigned char SUCCESS, FILE_OUTPUT_ERR if the file can't be written, or MEMORY_ERR if memory runs out.
+ */
+unsigned char game_export(game* g, const char* path);
+
+/**
+ * Exports the current game state to a file in the given format.
+ * @param g A pointer to the game struct to be exported.
+ * @param path The path to the file where the game state will be exported.
+ * @param format GMK_FORMAT_TEXT or GMK_FORMAT_BINARY.
+ * @return unsigned char SUCCESS, FILE_OUTPUT_ERR if the file can't be written, or MEMORY_ERR if memory runs out.
+ */
+unsigned char game_export_format(game* g, const char* path, unsigned char format);
+
+/**
+ * Writes game g to the open file fp in the given format, exactly as game_export_format() would write the whole file.
+ * The file is left open and isn't flushed.
+ * @param g A pointer to the game struct to be written.
+ * @param fp The file to write to.
+ * @param format GMK_FORMAT_TEXT or GMK_FORMAT_BINARY.
+ * @return unsigned char SUCCESS, FILE_OUTPUT_ERR if the file can't be written, or MEMORY_ERR if memory runs out.
  */
-void game_export(game* g, const char* path);
+unsigned char game_write(game* g, FILE* fp, unsigned char format);
 #endif
@@ -0,0 +1,240 @@
+/**
+* @file journal.c
+* @author Sadia Ahmed (sahmed23)
+* This file keeps an append-only journal of the moves of a game
+* so a game cut short by a crash can be recovered and resumed
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "journal.h"
+#include "io.h"
+#include "game.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * Writes length bytes of data to the file descriptor fd, retrying short and interrupted writes.
+ * @param fd The file descriptor.
+ * @param data The bytes to write.
+ * @param length The number of bytes.
+ * @return bool true if everything was written, false otherwise.
+ */
+static bool journal_write( int fd, const unsigned char* data, size_t length )
+{
+    while ( length > INITIALIZE ) {
+
+        // Storing the number of bytes written by this call
+        ssize_t written = write( fd, data, length );
+
+        if ( written < 0 && errno == EINTR ) {
+            continue;
+        } else if ( written <= 0 ) {
+            return false;
+        }
+
+        data += written;
+        length -= written;
+    }
+    return true;
+}
+
+/**
+ * Appends one entry to journal j and syncs once JOURNAL_SYNC_INTERVAL entries are pending.
+ * @param j A pointer to the journal.
+ * @param entry The 16-bit entry.
+ * @return unsigned char The status of the journal.
+ */
+static unsigned char journal_append( journal* j, unsigned int entry )
+{
+    // Storing the entry as written to the file
+    unsigned char bytes[JOURNAL_ENTRY_SIZE] = { entry & 0xFF, ( entry >> 8 ) & 0xFF };
+
+    if ( j->status != SUCCESS ) {
+        return j->status;
+    }
+
+    if ( !journal_write( j->fd, bytes, JOURNAL_ENTRY_SIZE ) ) {
+        j->status = FILE_OUTPUT_ERR;
+        return j->status;
+    }
+
+    if ( ++j->pending >= JOURNAL_SYNC_INTERVAL ) {
+        return journal_sync( j );
+    }
+    return SUCCESS;
+}
+
+unsigned char journal_open( const char* path, game* g, journal** j )
+{
+    *j = NULL;
+
+    // Storing the path of the temporary file the journal is built in
+    char* temp = malloc( strlen( path ) + strlen( JOURNAL_TEMP_SUFFIX ) + 1 );
+
+    // Storing the header and the moves so far
+    size_t length = JOURNAL_HEADER_SIZE + g->moves_count * JOURNAL_ENTRY_SIZE;
+    unsigned char* buffer = calloc( length, 1 );
+
+    // Create the dynamically allocated journal
+    journal* Journal = ( journal* ) calloc( 1, sizeof( journal ) );
+
+    if ( !temp || !buffer || !Journal ) {
+        free( temp );
+        free( buffer );
+        free( Journal );
+        return FILE_OUTPUT_ERR;
+    }
+
+    sprintf( temp, "%s" JOURNAL_TEMP_SUFFIX, path );
+
+    memcpy( buffer, JOURNAL_MAGIC, GMK_MAGIC_LENGTH );
+    buffer[2] = JOURNAL_VERSION;
+    buffer[3] = g->board->size;
+    buffer[4] = g->type;
+
+    for ( size_t i = INITIALIZE; i < g->moves_count; i++ ) {
+
+        // Storing the 16-bit code of the move
+        unsigned int code = g->moves[i].x | g->moves[i].y << GMK_COORD_BITS;
+
+        buffer[JOURNAL_HEADER_SIZE + i * JOURNAL_ENTRY_SIZE] = code & 0xFF;
+        buffer[JOURNAL_HEADER_SIZE + i * JOURNAL_ENTRY_SIZE + 1] = code >> 8;
+    }
+
+    // Writing the temporary file and putting it in place of path in one step
+    int fd = open( temp, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+
+    // Storing whether the journal is in place
+    bool written = fd >= 0 && journal_write( fd, buffer, length ) && fsync( fd ) == 0;
+
+    if ( fd >= 0 && close( fd ) != 0 ) {
+        written = false;
+    }
+
+    written = written && rename( temp, path ) == 0;
+
+    if ( !written ) {
+        unlink( temp );
+    }
+
+    free( temp );
+    free( buffer );
+
+    Journal->fd = written ? open( path, O_WRONLY | O_APPEND ) : -1;
+
+    if ( Journal->fd < 0 ) {
+        free( Journal );
+        return FILE_OUTPUT_ERR;
+    }
+
+    Journal->status = SUCCESS;
+    *j = Journal;
+
+    return SUCCESS;
+}
+
+unsigned char journal_move( journal* j, unsigned char x, unsigned char y )
+{
+    return journal_append( j, x | y << GMK_COORD_BITS );
+}
+
+unsigned char journal_undo( journal* j )
+{
+    return journal_append( j, JOURNAL_UNDO );
+}
+
+unsigned char journal_sync( journal* j )
+{
+    if ( j->status == SUCCESS && j->pending > INITIALIZE && fsync( j->fd ) != 0 ) {
+        j->status = FILE_OUTPUT_ERR;
+    }
+
+    j->pending = INITIALIZE;
+
+    return j->status;
+}
+
+unsigned char journal_close( journal* j )
+{
+    if ( !j ) {
+        return NULL_POINTER_ERR;
+    }
+
+    // Storing the status of the journal after the last sync
+    unsigned char status = journal_sync( j );
+
+    if ( close( j->fd ) != 0 ) {
+        status = FILE_OUTPUT_ERR;
+    }
+    free( j );
+
+    return status;
+}
+
+unsigned char journal_import( const void* data, size_t length, game** g )
+{
+    *g = NULL;
+
+    const unsigned char* bytes = ( const unsigned char* ) data;
+
+    if ( length < JOURNAL_HEADER_SIZE || memcmp( bytes, JOURNAL_MAGIC, GMK_MAGIC_LENGTH ) != 0 ||
+         bytes[2] != JOURNAL_VERSION || ( bytes[4] != GAME_FREESTYLE && bytes[4] != GAME_RENJU ) ) {
+        return FILE_INPUT_ERR;
+    }
+
+    if ( bytes[3] != 15 && bytes[3] != 17 && bytes[3] != 19 ) {
+        return BOARD_SIZE_ERR;
+    }
+
+    game* Game = game_create( bytes[3], bytes[4] );
+
+    if ( !Game ) {
+        return MEMORY_ERR;
+    }
+
+    // Playing every whole entry again, a torn last one is left out
+    for ( size_t i = JOURNAL_HEADER_SIZE; i + JOURNAL_ENTRY_SIZE <= length; i += JOURNAL_ENTRY_SIZE ) {
+
+        // Storing the entry
+        unsigned int entry = bytes[i] | bytes[i + 1] << 8;
+
+        // Storing whether the entry could be played
+        bool played = entry == JOURNAL_UNDO
+            ? game_unplace_stone( Game )
+            : ( entry >> GMK_COORD_BITS ) < Game->board->size &&
+              game_place_stone( Game, entry & GMK_COORD_MASK, entry >> GMK_COORD_BITS );
+
+        if ( !played ) {
+            game_delete( Game );
+            return FILE_INPUT_ERR;
+        }
+    }
+
+    if ( Game->state == GAME_STATE_PLAYING ) {
+        Game->state = GAME_STATE_STOPPED;
+    }
+
+    // The entries were played to check them, but an imported game starts from an empty board like the other formats
+    board* Board = board_create( Game->board->size );
+
+    if ( !Board ) {
+        game_delete( Game );
+        return MEMORY_ERR;
+    }
+
+    board_delete( Game->board );
+    Game->board = Board;
+    Game->stone = BLACK_STONE;
+
+    *g = Game;
+
+    return SUCCESS;
+}
@@ -0,0 +1,87 @@
+#ifndef _JOURNAL_H_
+#define _JOURNAL_H_
+#include "game.h"
+#include <stddef.h>
+
+#define JOURNAL_MAGIC "GJ"
+#define JOURNAL_VERSION 1
+#define JOURNAL_HEADER_SIZE 8
+#define JOURNAL_ENTRY_SIZE 2
+#define JOURNAL_UNDO 0xFFFF
+#define JOURNAL_SYNC_INTERVAL 8
+#define JOURNAL_TEMP_SUFFIX ".tmp"
+
+/*
+ * Journal (version 1) layout, all multi-byte fields little-endian:
+ *   0  "GJ"          magic
+ *   2  version       JOURNAL_VERSION
+ *   3  size          15, 17 or 19
+ *   4  type          GAME_FREESTYLE or GAME_RENJU
+ *   5  reserved      0, 0, 0
+ *   8  entries       16-bit per entry: x | y << GMK_COORD_BITS for a move, JOURNAL_UNDO for a move taken back
+ * Entries are only ever appended. A last entry cut short by a crash is ignored.
+ */
+
+/**
+ * A journal open for appending. Every entry is written to the file as it happens, so it survives the process;
+ * fsync() runs every JOURNAL_SYNC_INTERVAL entries, when the game ends, and on close, so it survives the machine too.
+ * pending counts the entries written since the last fsync(), status is the first error met, or SUCCESS.
+ */
+typedef struct journal {
+    int fd;
+    unsigned int pending;
+    unsigned char status;
+} journal;
+
+/**
+ * This function starts the journal at path for game g and stores it in j. The header and every move g already has are written
+ * to a temporary file which is synced and renamed over path, so path always holds a whole journal; further entries are appended.
+ * @param path The path to the journal.
+ * @param g A pointer to the game struct being journaled.
+ * @param j A pointer to store the open journal, set to NULL on error.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if the journal can't be written.
+ */
+unsigned char journal_open(const char* path, game* g, journal** j);
+
+/**
+ * This function appends a move at x, y to journal j, and syncs it if JOURNAL_SYNC_INTERVAL entries are now pending.
+ * @param j A pointer to the journal.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if this or an earlier entry couldn't be written.
+ */
+unsigned char journal_move(journal* j, unsigned char x, unsigned char y);
+
+/**
+ * This function appends a JOURNAL_UNDO entry to journal j, like journal_move().
+ * @param j A pointer to the journal.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if this or an earlier entry couldn't be written.
+ */
+unsigned char journal_undo(journal* j);
+
+/**
+ * This function syncs the pending entries of journal j to disk with fsync().
+ * @param j A pointer to the journal.
+ * @return unsigned char SUCCESS, or FILE_OUTPUT_ERR if this or an earlier entry couldn't be written.
+ */
+unsigned char journal_sync(journal* j);
+
+/**
+ * This function syncs and closes journal j and frees it.
+ * If j is NULL, return NULL_POINTER_ERR as defined in error-codes.h.
+ * @param j A pointer to the journal.
+ * @return unsigned char SUCCESS, NULL_POINTER_ERR, or FILE_OUTPUT_ERR if any entry couldn't be written.
+ */
+unsigned char journal_close(journal* j);
+
+/**
+ * This function recovers a game from the length bytes of a journal at data, playing every entry again
+ * with game_place_stone() and game_unplace_stone(). A game still being played when the journal ends is GAME_STATE_STOPPED,
+ * so it can be resumed like a saved game.
+ * @param data The contents of the journal.
+ * @param length The length of the contents.
+ * @param g A pointer to store the recovered game struct, set to NULL on error.
+ * @return unsigned char SUCCESS, FILE_INPUT_ERR if the journal is invalid, BOARD_SIZE_ERR for an unsupported board size, or MEMORY_ERR if memory runs out.
+ */
+unsigned char journal_import(const void* data, size_t length, game** g);
+#endif
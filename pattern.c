@@ -0,0 +1,244 @@
+/**
+* @file pattern.c
+* @author Sadia Ahmed (sahmed23)
+* This file classifies board lines into fives, fours and threes
+* with a lookup table keyed by the encoded line window
+*/
+
+#include "pattern.h"
+#include "board.h"
+#include "game.h"
+
+#include <stdbool.h>
+#include <pthread.h>
+
+// Window cell values used while building the table
+#define CELL_EMPTY 0
+#define CELL_OWN 1
+#define CELL_BLOCKED 2
+
+// Number of distinct 5 bit halves of a window
+#define HALF_MASKS 32
+
+// The line class and key points of every encoded window, per rule
+static uint16_t pattern_table[PATTERN_RULES][PATTERN_TABLE_SIZE];
+
+// Base 3 value of every 10 bit mask of window cells, the center excluded
+static uint16_t pattern_ternary[1 << PATTERN_CELLS];
+
+// Makes sure the tables are built once, whichever thread looks up a line first
+static pthread_once_t pattern_once = PTHREAD_ONCE_INIT;
+
+/**
+ * This function returns the length of the run of own stones through the center of the window,
+ * and stores its first and last window index in start and end.
+ * @param window The line window.
+ * @param start A pointer to store the first index of the run.
+ * @param end A pointer to store the last index of the run.
+ * @return int The number of consecutive own stones through the center.
+ */
+static int pattern_center_run( const unsigned char window[PATTERN_WINDOW], int* start, int* end )
+{
+    *start = PATTERN_CENTER;
+    *end = PATTERN_CENTER;
+
+    while ( *start > INITIALIZE && window[*start - 1] == CELL_OWN ) {
+        ( *start )--;
+    }
+
+    while ( *end < PATTERN_WINDOW - 1 && window[*end + 1] == CELL_OWN ) {
+        ( *end )++;
+    }
+
+    return *end - *start + 1;
+}
+
+/**
+ * This function returns true if a run of the given length wins under rule.
+ * @param run The length of the run.
+ * @param rule PATTERN_EXACT_FIVE or PATTERN_FIVE_OR_MORE.
+ * @return bool true if the run is a five.
+ */
+static bool pattern_is_five( int run, unsigned char rule )
+{
+    return rule == PATTERN_EXACT_FIVE ? run == WIN_CONDITION : run >= WIN_CONDITION;
+}
+
+/**
+ * This function returns the mask of the empty window entries that would complete a five through the center.
+ * @param window The line window, left unchanged.
+ * @param rule PATTERN_EXACT_FIVE or PATTERN_FIVE_OR_MORE.
+ * @return int The mask of five points.
+ */
+static int pattern_five_points( unsigned char window[PATTERN_WINDOW], unsigned char rule )
+{
+    // Storing the mask of the points found
+    int points = INITIALIZE;
+
+    for ( int e = 1; e < PATTERN_WINDOW - 1; e++ ) {
+
+        if ( window[e] != CELL_EMPTY ) {
+            continue;
+        }
+
+        // Storing the bounds of the run through the center
+        int start;
+        int end;
+
+        window[e] = CELL_OWN;
+        if ( pattern_is_five( pattern_center_run( window, &start, &end ), rule ) && start <= e && e <= end ) {
+            points |= 1 << e;
+        }
+        window[e] = CELL_EMPTY;
+    }
+
+    return points;
+}
+
+/**
+ * This function classifies the fours of a window from its five points.
+ * Two five points on either end of the same four stones are a single straight four.
+ * @param points The mask of five points.
+ * @return int PATTERN_NONE, PATTERN_FOUR, PATTERN_STRAIGHT_FOUR or PATTERN_DOUBLE_FOUR.
+ */
+static int pattern_four_type( int points )
+{
+    if ( points == INITIALIZE ) {
+        return PATTERN_NONE;
+    }
+
+    if ( ( points & ( points - 1 ) ) == INITIALIZE ) {
+        return PATTERN_FOUR;
+    }
+
+    // Storing the lowest five point
+    int first = __builtin_ctz( points );
+
+    return points == ( ( 1 << first ) | ( 1 << ( first + WIN_CONDITION ) ) ) ? PATTERN_STRAIGHT_FOUR : PATTERN_DOUBLE_FOUR;
+}
+
+/**
+ * This function computes the table entry of a window.
+ * @param window The line window, with the center occupied by an own stone.
+ * @param rule PATTERN_EXACT_FIVE or PATTERN_FIVE_OR_MORE.
+ * @return uint16_t The entry, see pattern_type() and pattern_points().
+ */
+static uint16_t pattern_classify( unsigned char window[PATTERN_WINDOW], unsigned char rule )
+{
+    // Storing the bounds of the run through the center
+    int start;
+    int end;
+
+    // Storing the length of the run through the center
+    int run = pattern_center_run( window, &start, &end );
+
+    if ( pattern_is_five( run, rule ) ) {
+        return PATTERN_FIVE << PATTERN_POINTS_BITS;
+    } else if ( run > WIN_CONDITION ) {
+        return PATTERN_OVERLINE << PATTERN_POINTS_BITS;
+    }
+
+    // Storing the five points of the line
+    int points = pattern_five_points( window, rule );
+
+    if ( points != INITIALIZE ) {
+        return ( pattern_four_type( points ) << PATTERN_POINTS_BITS ) | points;
+    }
+
+    // Storing the points that turn the line into a straight four
+    int straight_points = INITIALIZE;
+
+    for ( int e = 1; e < PATTERN_WINDOW - 1; e++ ) {
+
+        if ( window[e] != CELL_EMPTY ) {
+            continue;
+        }
+
+        window[e] = CELL_OWN;
+        if ( pattern_four_type( pattern_five_points( window, rule ) ) == PATTERN_STRAIGHT_FOUR ) {
+            straight_points |= 1 << e;
+        }
+        window[e] = CELL_EMPTY;
+    }
+
+    if ( straight_points != INITIALIZE ) {
+        return ( PATTERN_THREE << PATTERN_POINTS_BITS ) | straight_points;
+    }
+
+    return PATTERN_NONE << PATTERN_POINTS_BITS;
+}
+
+/**
+ * This function builds the base 3 conversion table and the pattern tables for both rules.
+ */
+static void pattern_init( void )
+{
+    for ( int mask = INITIALIZE; mask < ( 1 << PATTERN_CELLS ); mask++ ) {
+
+        // Storing the base 3 value and the weight of the current digit
+        int value = INITIALIZE;
+        int weight = 1;
+
+        for ( int i = INITIALIZE; i < PATTERN_CELLS; i++ ) {
+            if ( mask & ( 1 << i ) ) {
+                value += weight;
+            }
+            weight *= 3;
+        }
+
+        pattern_ternary[mask] = value;
+    }
+
+    // Storing the window being decoded
+    unsigned char window[PATTERN_WINDOW];
+
+    for ( int index = INITIALIZE; index < PATTERN_TABLE_SIZE; index++ ) {
+
+        // Storing the remaining digits of the index
+        int digits = index;
+
+        for ( int i = INITIALIZE; i < PATTERN_WINDOW; i++ ) {
+            if ( i == PATTERN_CENTER ) {
+                window[i] = CELL_OWN;
+                continue;
+            }
+            window[i] = digits % 3;
+            digits /= 3;
+        }
+
+        for ( unsigned char rule = INITIALIZE; rule < PATTERN_RULES; rule++ ) {
+            pattern_table[rule][index] = pattern_classify( window, rule );
+        }
+    }
+}
+
+/**
+ * This function cuts the window around bit pos out of a line bitmask and drops the center,
+ * giving the PATTERN_CELLS bit mask the ternary table is indexed with.
+ * @param line The bitmask of a board line.
+ * @param pos The bit index of the center.
+ * @return int The window mask without the center bit.
+ */
+static int pattern_cells( uint32_t line, unsigned char pos )
+{
+    // Storing the window bits, bits that fall off either end of the line stay zero
+    uint32_t window = ( uint32_t ) ( ( ( uint64_t ) line << PATTERN_CENTER ) >> pos ) & ( ( 1 << PATTERN_WINDOW ) - 1 );
+
+    return ( window & ( HALF_MASKS - 1 ) ) | ( ( window >> ( PATTERN_CENTER + 1 ) ) << PATTERN_CENTER );
+}
+
+
+uint16_t pattern_line( board* b, unsigned char x, unsigned char y, unsigned char direction, unsigned char stone, unsigned char rule )
+{
+    pthread_once( &pattern_once, pattern_init );
+
+    // Storing the bit index of x, y in the line
+    unsigned char pos = board_line_index( direction, x, y );
+
+    // Storing the own stones and the empty intersections around x, y; everything else is blocked
+    int own = pattern_cells( board_line( b, x, y, direction, stone ), pos );
+    int empty = pattern_cells( board_line( b, x, y, direction, EMPTY_INTERSECTION ), pos );
+    int blocked = ( ( 1 << PATTERN_CELLS ) - 1 ) & ~( own | empty );
+
+    return pattern_table[rule][pattern_ternary[own] + 2 * pattern_ternary[blocked]];
+}
@@ -0,0 +1,55 @@
+#ifndef _PATTERN_H_
+#define _PATTERN_H_
+#include "board.h"
+#include <stdint.h>
+
+#define PATTERN_WINDOW 11
+#define PATTERN_CENTER 5
+#define PATTERN_CELLS ( PATTERN_WINDOW - 1 )
+#define PATTERN_TABLE_SIZE 59049
+#define PATTERN_POINTS_BITS 11
+#define PATTERN_POINTS_MASK ( ( 1 << PATTERN_POINTS_BITS ) - 1 )
+
+#define PATTERN_EXACT_FIVE 0
+#define PATTERN_FIVE_OR_MORE 1
+#define PATTERN_RULES 2
+
+#define PATTERN_NONE 0
+#define PATTERN_THREE 1
+#define PATTERN_FOUR 2
+#define PATTERN_STRAIGHT_FOUR 3
+#define PATTERN_DOUBLE_FOUR 4
+#define PATTERN_FIVE 5
+#define PATTERN_OVERLINE 6
+
+/**
+ * The pattern class of a line entry returned by pattern_line().
+ */
+#define pattern_type(entry) ((entry) >> PATTERN_POINTS_BITS)
+
+/**
+ * The key points of a line entry returned by pattern_line(), bit i standing for window index i,
+ * that is the intersection i - PATTERN_CENTER steps away from the center along the line.
+ * For the four classes these are the points that complete a five,
+ * for PATTERN_THREE they are the points that make a straight four.
+ */
+#define pattern_points(entry) ((entry) & PATTERN_POINTS_MASK)
+
+/**
+ * This function classifies the line through x and y in the given direction for the player stone,
+ * treating x, y as occupied by stone whether or not it is, so it can also evaluate a move before it is played.
+ * The line is read as a window of PATTERN_CENTER intersections on each side of x, y, where the opponent's stones and
+ * the board edge both count as blocked, encoded in base 3 and looked up in a table built once on first use.
+ * Under PATTERN_EXACT_FIVE (Renju black) only exactly five wins and longer runs are PATTERN_OVERLINE;
+ * under PATTERN_FIVE_OR_MORE (freestyle, Renju white) any run of five or more is PATTERN_FIVE.
+ * Only shapes that include x, y are reported.
+ * @param b A pointer to the board struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param direction The direction of the line as defined in board.h.
+ * @param stone The player's stone type (BLACK_STONE or WHITE_STONE).
+ * @param rule PATTERN_EXACT_FIVE or PATTERN_FIVE_OR_MORE.
+ * @return uint16_t The line entry, read with pattern_type() and pattern_points().
+ */
+uint16_t pattern_line(board* b, unsigned char x, unsigned char y, unsigned char direction, unsigned char stone, unsigned char rule);
+#endif
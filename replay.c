@@ -12,6 +12,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 
 /**
@@ -34,19 +35,40 @@ int main( int argc, char *argv[] )
         exit( FILE_INPUT_ERR );
     }
 
-    if ( argc != 2 ) {
-        printf( "usage: %s <saved-match.gmk>\n", argv[0] );
+    // Storing the move to show with --at, or -1 to replay the whole game
+    long at = BLANK_COORD;
+
+    // Storing the end of the number after --at
+    char* end = NULL;
+
+    if ( argc == 4 && strcmp( argv[1], "--at" ) == 0 ) {
+        at = strtol( argv[2], &end, 10 );
+
+        if ( *argv[2] == '\0' || *end != '\0' || at < INITIALIZE ) {
+            printf( "usage: %s [--at <move>] <saved-match.gmk>\n", argv[0] );
+            exit( ARGUMENT_ERR );
+        }
+    } else if ( argc != 2 ) {
+        printf( "usage: %s [--at <move>] <saved-match.gmk>\n", argv[0] );
         exit( ARGUMENT_ERR );
     }
 
-    game *Game = game_import( argv[1] );
-    if ( !Game ) {
-        printf( "Failed to import game from %s\n", argv[1] );
-        exit( ARGUMENT_ERR );
+    game *Game = NULL;
+
+    // Storing the status of the import
+    unsigned char status = game_import( argv[argc - 1], &Game );
+
+    if ( status != SUCCESS ) {
+        exit( status );
+    }
+
+    if ( at == BLANK_COORD ) {
+        game_replay( Game );
+    } else {
+        status = game_replay_at( Game, ( size_t ) at );
     }
 
-    game_replay( Game );
     game_delete( Game );
 
-    return EXIT_SUCCESS;
+    return status;
 }
\ No newline at end of file
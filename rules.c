@@ -0,0 +1,121 @@
+/**
+* @file rules.c
+* @author Sadia Ahmed (sahmed23)
+* This file classifies black moves under the Renju rules
+* from the line patterns of the four lines through the move
+*/
+
+#include "rules.h"
+#include "pattern.h"
+#include "board.h"
+#include "game.h"
+
+#include <stdbool.h>
+
+// Steps along each direction, indexed by the DIRECTION_* constants
+static const int direction_dx[BOARD_DIRECTIONS] = { 1, 0, 1, 1 };
+static const int direction_dy[BOARD_DIRECTIONS] = { 0, 1, 1, -1 };
+
+
+unsigned char rules_renju_black( board* b, unsigned char x, unsigned char y )
+{
+    // Storing the pattern of each line through the move
+    uint16_t lines[BOARD_DIRECTIONS];
+
+    // Storing whether any line is an overline
+    bool overline = false;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+        lines[direction] = pattern_line( b, x, y, direction, BLACK_STONE, PATTERN_EXACT_FIVE );
+
+        // Exactly five wins straight away, even if another line is forbidden
+        if ( pattern_type( lines[direction] ) == PATTERN_FIVE ) {
+            return RULES_FIVE;
+        } else if ( pattern_type( lines[direction] ) == PATTERN_OVERLINE ) {
+            overline = true;
+        }
+    }
+
+    if ( overline ) {
+        return RULES_OVERLINE;
+    }
+
+    // Storing the number of fours and of lines that look like open threes
+    int fours = INITIALIZE;
+    int candidates = INITIALIZE;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+        switch ( pattern_type( lines[direction] ) ) {
+            case PATTERN_DOUBLE_FOUR:
+                fours += MAX_VIOLATIONS;
+                break;
+            case PATTERN_FOUR:
+            case PATTERN_STRAIGHT_FOUR:
+                fours++;
+                break;
+            case PATTERN_THREE:
+                candidates++;
+                break;
+        }
+    }
+
+    if ( fours >= MAX_VIOLATIONS ) {
+        return RULES_DOUBLE_FOUR;
+    }
+
+    if ( candidates < MAX_VIOLATIONS ) {
+        return RULES_NONE;
+    }
+
+    // Storing the number of threes that survive the forbidden point check
+    int threes = INITIALIZE;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+        if ( pattern_type( lines[direction] ) != PATTERN_THREE ) {
+            continue;
+        }
+
+        // Storing the straight four points not yet tried
+        int points = pattern_points( lines[direction] );
+
+        while ( points ) {
+
+            // Storing the board coordinates of the straight four point
+            int offset = __builtin_ctz( points ) - PATTERN_CENTER;
+            unsigned char px = x + offset * direction_dx[direction];
+            unsigned char py = y + offset * direction_dy[direction];
+
+            points &= points - 1;
+
+            if ( !rules_is_forbidden( b, px, py ) ) {
+                threes++;
+                break;
+            }
+        }
+
+        if ( threes >= MAX_VIOLATIONS ) {
+            return RULES_DOUBLE_THREE;
+        }
+    }
+
+    return RULES_NONE;
+}
+
+
+bool rules_is_forbidden( board* b, unsigned char x, unsigned char y )
+{
+    if ( board_get( b, x, y ) != EMPTY_INTERSECTION ) {
+        return false;
+    }
+
+    board_set( b, x, y, BLACK_STONE );
+
+    // Storing the classification of the trial stone
+    unsigned char result = rules_renju_black( b, x, y );
+
+    board_unset( b, x, y );
+
+    return result != RULES_NONE && result != RULES_FIVE;
+}
@@ -0,0 +1,35 @@
+#ifndef _RULES_H_
+#define _RULES_H_
+#include "board.h"
+#include <stdbool.h>
+
+#define RULES_NONE 0
+#define RULES_FIVE 1
+#define RULES_OVERLINE 2
+#define RULES_DOUBLE_FOUR 3
+#define RULES_DOUBLE_THREE 4
+
+/**
+ * This function classifies a black stone that has just been placed at x and y under the Renju rules,
+ * looking only at the four lines through x, y, each classified by pattern_line().
+ * It returns RULES_FIVE if the stone makes exactly five in a row, which wins even if it would also be forbidden.
+ * Otherwise it returns RULES_OVERLINE, RULES_DOUBLE_FOUR or RULES_DOUBLE_THREE if the move is forbidden for that reason,
+ * or RULES_NONE if the move is neither winning nor forbidden.
+ * An open three only counts if the point that turns it into a straight four is not itself forbidden.
+ * @param b A pointer to the board struct, with a black stone at x, y.
+ * @param x The horizontal coordinate of the move.
+ * @param y The vertical coordinate of the move.
+ * @return unsigned char The classification of the move.
+ */
+unsigned char rules_renju_black(board* b, unsigned char x, unsigned char y);
+
+/**
+ * This function returns true if playing a black stone on the empty intersection x, y would be a forbidden move
+ * (overline, four-four or three-three) that doesn't also make five. The board is left unchanged.
+ * @param b A pointer to the board struct.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @return bool true if the move is forbidden for black.
+ */
+bool rules_is_forbidden(board* b, unsigned char x, unsigned char y);
+#endif
@@ -0,0 +1,317 @@
+/**
+* @file solve.c
+* @author Sadia Ahmed (sahmed23)
+* This file proves or disproves a win from a saved position
+* with depth-first proof-number search, checkpointing to disk as it goes
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "dfpn.h"
+#include "io.h"
+#include "board.h"
+#include "game.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <limits.h>
+#include <unistd.h>
+
+/**
+ * Stops the solve on SIGINT or SIGTERM, which then saves its checkpoint and reports.
+ * @param signal The signal number.
+ */
+static void solve_signal( int signal )
+{
+    ( void ) signal;
+    dfpn_interrupt( );
+}
+
+/**
+ * Prints the usage of solve.
+ * @param name The name of the executable.
+ */
+static void solve_usage( const char* name )
+{
+    printf( "usage: %s [-a <moves>] [-b | -c <checkpoint>] [-i <seconds>] [-j <threads>] [-m <megabytes>] [-n <nodes>] [-t <seconds>] <saved-match.gmk>\n", name );
+}
+
+/**
+ * Reads the number after an option.
+ * @param argc the number of terminal arguments
+ * @param argv the arguments
+ * @param i A pointer to the index of the option, advanced past the number.
+ * @param value A pointer to store the number.
+ * @return bool true if a non-negative number follows the option.
+ */
+static bool solve_number( int argc, char *argv[], int* i, unsigned long* value )
+{
+    // Storing the end of the number
+    char* end = NULL;
+
+    if ( *i + 1 >= argc || argv[*i + 1][0] == '-' ) {
+        return false;
+    }
+
+    *value = strtoul( argv[++( *i )], &end, 10 );
+
+    return *argv[*i] != '\0' && *end == '\0';
+}
+
+/**
+ * Returns the seconds between two times.
+ * @param start The earlier time.
+ * @param stop The later time.
+ * @return double The seconds between them.
+ */
+static double solve_seconds( struct timespec start, struct timespec stop )
+{
+    return ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+}
+
+/**
+ * Solves the position of g from an empty table with 1, 2, 4 and so on up to threads threads, and prints for each
+ * the outcome, the nodes, the seconds and the speedup over one thread.
+ * @param g A pointer to the game struct.
+ * @param limits A pointer to the budget of every solve, without a checkpoint.
+ * @param megabytes The size of the table in megabytes.
+ * @param threads The largest number of threads.
+ * @return unsigned char SUCCESS, or MEMORY_ERR if a table can't be created.
+ */
+static unsigned char solve_benchmark( game* g, dfpn_limits* limits, unsigned long megabytes, unsigned int threads )
+{
+    // Storing the seconds taken by one thread
+    double single = INITIALIZE;
+
+    printf( "threads  outcome  nodes        seconds   nodes/s     speedup\n" );
+
+    for ( unsigned int count = 1; count <= threads; count = count < threads && count * 2 > threads ? threads : count * 2 ) {
+
+        // Storing a fresh table, the outcome and the time the solve took
+        dfpn_table* table = dfpn_table_create( g, megabytes );
+        dfpn_result result;
+        struct timespec start;
+        struct timespec stop;
+
+        if ( !table ) {
+            return MEMORY_ERR;
+        }
+
+        limits->threads = count;
+        clock_gettime( CLOCK_MONOTONIC, &start );
+        dfpn_solve( g, table, limits, &result );
+        clock_gettime( CLOCK_MONOTONIC, &stop );
+        dfpn_table_delete( table );
+
+        // Storing the seconds taken
+        double seconds = solve_seconds( start, stop );
+
+        if ( count == 1 ) {
+            single = seconds;
+        }
+
+        printf( "%-8u %-8s %-12lu %-9.2f %-11.0f %.2f\n", count,
+                result.outcome == DFPN_PROVEN ? "win" : result.outcome == DFPN_DISPROVEN ? "no win" : "unknown",
+                result.nodes, seconds, seconds > INITIALIZE ? result.nodes / seconds : INITIALIZE, seconds > INITIALIZE ? single / seconds : 1.0 );
+
+        if ( count == threads ) {
+            break;
+        }
+    }
+
+    return SUCCESS;
+}
+
+/**
+ * Proves or disproves a win for the side to move in a saved game, after its first moves (-a, all of them by default).
+ * The proof and disproof numbers are kept in a table of -m megabytes; with -c they are loaded from the checkpoint if it exists
+ * and saved to it every -i seconds, on SIGINT or SIGTERM, and at the end, so a long solve can be stopped and resumed.
+ * With -i 0 it is only saved on SIGINT or SIGTERM and at the end.
+ * -n and -t bound the nodes and seconds of this run, and -j sets the threads searching, one per online processor
+ * by default, up to DFPN_MAX_THREADS.
+ * -b benchmarks the solve instead, with up to -j threads and no checkpoint.
+ * @param argc the number of terminal arguments defined by user
+ * @param the array of arguments themselves
+ * @return SUCCESS, or the error status
+ */
+int main( int argc, char *argv[] )
+{
+
+    // Storing the length of the filename for comparison
+    size_t str_length_one = strlen( argv[0] );
+
+    // Storing the part of the file name to compare to
+    char src_path[DEFAULT_STRING_LENGTH] = "solve";
+
+    // Storing the length of the file name to compare to
+    size_t str_length_two = strlen( src_path );
+
+    if ( str_length_one < str_length_two || strncmp( argv[0] + str_length_one - str_length_two, src_path, str_length_two ) != 0 ) {
+        exit( FILE_INPUT_ERR );
+    }
+
+    // Storing the options, the position is the whole game by default
+    unsigned long at = ULONG_MAX;
+    unsigned long megabytes = DFPN_DEFAULT_MB;
+    long processors = sysconf( _SC_NPROCESSORS_ONLN );
+    unsigned long threads = processors < 1 ? 1 : processors > DFPN_MAX_THREADS ? DFPN_MAX_THREADS : ( unsigned long ) processors;
+    dfpn_limits limits = { INITIALIZE, INITIALIZE, NULL, DFPN_DEFAULT_CHECKPOINT_SECONDS, INITIALIZE };
+    const char* path = NULL;
+    bool benchmark = false;
+
+    for ( int i = 1; i < argc; i++ ) {
+
+        // Storing whether the option is well formed
+        bool valid = true;
+
+        if ( strcmp( "-a", argv[i] ) == 0 ) {
+            valid = solve_number( argc, argv, &i, &at );
+        } else if ( strcmp( "-b", argv[i] ) == 0 ) {
+            benchmark = true;
+        } else if ( strcmp( "-c", argv[i] ) == 0 ) {
+            valid = i + 1 < argc;
+            limits.checkpoint = valid ? argv[++i] : NULL;
+        } else if ( strcmp( "-i", argv[i] ) == 0 ) {
+            valid = solve_number( argc, argv, &i, &limits.checkpoint_seconds );
+        } else if ( strcmp( "-j", argv[i] ) == 0 ) {
+            valid = solve_number( argc, argv, &i, &threads ) && threads >= 1 && threads <= DFPN_MAX_THREADS;
+        } else if ( strcmp( "-m", argv[i] ) == 0 ) {
+            valid = solve_number( argc, argv, &i, &megabytes ) && megabytes > INITIALIZE;
+        } else if ( strcmp( "-n", argv[i] ) == 0 ) {
+            valid = solve_number( argc, argv, &i, &limits.max_nodes );
+        } else if ( strcmp( "-t", argv[i] ) == 0 ) {
+            valid = solve_number( argc, argv, &i, &limits.max_seconds );
+        } else if ( !path ) {
+            path = argv[i];
+        } else {
+            valid = false;
+        }
+
+        if ( !valid ) {
+            solve_usage( argv[0] );
+            exit( ARGUMENT_ERR );
+        }
+    }
+
+    if ( !path || ( benchmark && limits.checkpoint ) ) {
+        solve_usage( argv[0] );
+        exit( ARGUMENT_ERR );
+    }
+
+    game* Saved = NULL;
+
+    // Storing the status of the import
+    unsigned char status = game_import( path, &Saved );
+
+    if ( status != SUCCESS ) {
+        exit( status );
+    }
+
+    // Storing the position to solve, the saved moves played again under the rules
+    game* Game = game_create( Saved->board->size, Saved->type );
+
+    if ( !Game ) {
+        game_delete( Saved );
+        exit( MEMORY_ERR );
+    }
+
+    for ( size_t i = INITIALIZE; i < Saved->moves_count && i < at && Game->state == GAME_STATE_PLAYING; i++ ) {
+        if ( !game_place_stone( Game, Saved->moves[i].x, Saved->moves[i].y ) ) {
+            printf( "Move %zu of %zu in %s can't be played.\n", i + 1, Saved->moves_count, path );
+            game_delete( Saved );
+            game_delete( Game );
+            exit( FILE_INPUT_ERR );
+        }
+    }
+    game_delete( Saved );
+
+    if ( Game->state != GAME_STATE_PLAYING ) {
+        printf( "The game is over, there is nothing to solve.\n" );
+        game_delete( Game );
+        exit( RESUME_ERR );
+    }
+
+    if ( benchmark ) {
+
+        // Storing the status of the benchmark
+        unsigned char benchmark_status = solve_benchmark( Game, &limits, megabytes, threads );
+
+        game_delete( Game );
+
+        return benchmark_status;
+    }
+
+    limits.threads = threads;
+
+    // Storing the table, resumed from the checkpoint if there is one
+    dfpn_table* table = NULL;
+    FILE* checkpoint = limits.checkpoint ? fopen( limits.checkpoint, "rb" ) : NULL;
+
+    if ( checkpoint ) {
+        fclose( checkpoint );
+        if ( dfpn_table_load( limits.checkpoint, &table ) != SUCCESS ) {
+            printf( "The checkpoint %s can't be read.\n", limits.checkpoint );
+            game_delete( Game );
+            exit( FILE_INPUT_ERR );
+        }
+    } else {
+        table = dfpn_table_create( Game, megabytes );
+    }
+
+    if ( !table ) {
+        game_delete( Game );
+        exit( MEMORY_ERR );
+    }
+
+    // Storing the handler of SIGINT and SIGTERM, installed once the flag is cleared so an early signal isn't lost
+    struct sigaction action;
+
+    memset( &action, INITIALIZE, sizeof( action ) );
+    action.sa_handler = solve_signal;
+    sigemptyset( &action.sa_mask );
+    dfpn_interrupt_reset( );
+    sigaction( SIGINT, &action, NULL );
+    sigaction( SIGTERM, &action, NULL );
+
+    // Storing the outcome and the time the solve started
+    dfpn_result result;
+    time_t start = time( NULL );
+
+    if ( !dfpn_solve( Game, table, &limits, &result ) ) {
+        printf( "The checkpoint %s is for another board, rules or side to move.\n", limits.checkpoint );
+        dfpn_table_delete( table );
+        game_delete( Game );
+        exit( ARGUMENT_ERR );
+    }
+
+    // Storing the side to move and the move found
+    const char* side = Game->stone == BLACK_STONE ? "Black" : "White";
+    char coord[DEFAULT_STRING_LENGTH] = "-";
+
+    if ( result.x < BOARD_MAX_SIZE ) {
+        board_formal_coord( Game->board, result.x, result.y, coord );
+    }
+
+    if ( result.outcome == DFPN_PROVEN ) {
+        printf( "%s wins, playing %s.\n", side, coord );
+    } else if ( result.outcome == DFPN_DISPROVEN ) {
+        printf( "%s can't force a win.\n", side );
+    } else {
+        printf( "Unknown: proof number %u, disproof number %u, most promising move %s.\n", result.pn, result.dn, coord );
+    }
+    printf( "%lu nodes in %ld s.\n", result.nodes, ( long ) ( time( NULL ) - start ) );
+
+    if ( result.status != SUCCESS ) {
+        printf( "The checkpoint %s can't be written.\n", limits.checkpoint );
+    }
+
+    dfpn_table_delete( table );
+    game_delete( Game );
+
+    return result.status;
+}
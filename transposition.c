@@ -0,0 +1,190 @@
+/**
+* @file transposition.c
+* @author Sadia Ahmed (sahmed23)
+* This file caches search results by position
+* in fixed-size tables of cache-line buckets, one per thread by default
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "transposition.h"
+#include "game.h"
+#include "board.h"
+#include "error-codes.h"
+
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+// The key of each thread's table for the searches that aren't given one, created once
+static pthread_key_t transposition_local_key;
+static pthread_once_t transposition_local_once = PTHREAD_ONCE_INIT;
+
+/**
+ * This function frees the table of a thread as the thread exits.
+ * @param table A pointer to the table.
+ */
+static void transposition_local_free( void* table )
+{
+    transposition_delete( ( transposition* ) table );
+}
+
+/**
+ * This function creates the key of the threads' tables.
+ */
+static void transposition_local_init( void )
+{
+    pthread_key_create( &transposition_local_key, transposition_local_free );
+}
+
+transposition* transposition_create( size_t megabytes )
+{
+    // Storing the number of buckets, the largest power of two that fits
+    size_t buckets = 1;
+
+    while ( buckets * 2 * sizeof( transposition_bucket ) <= megabytes * 1024 * 1024 ) {
+        buckets *= 2;
+    }
+
+    // Create the dynamically allocated table
+    transposition* Table = ( transposition* ) malloc( sizeof( transposition ) );
+
+    if ( !Table ) {
+        return NULL;
+    }
+
+    if ( posix_memalign( ( void** ) &Table->buckets, TRANSPOSITION_CACHE_LINE, buckets * sizeof( transposition_bucket ) ) != 0 ) {
+        free( Table );
+        return NULL;
+    }
+
+    Table->mask = buckets - 1;
+    transposition_clear( Table );
+
+    return Table;
+}
+
+unsigned char transposition_delete( transposition* t )
+{
+    if ( !t ) {
+        return NULL_POINTER_ERR;
+    }
+
+    free( t->buckets );
+    free( t );
+
+    return SUCCESS;
+}
+
+void transposition_clear( transposition* t )
+{
+    memset( t->buckets, INITIALIZE, ( t->mask + 1 ) * sizeof( transposition_bucket ) );
+    t->generation = INITIALIZE;
+    t->probes = INITIALIZE;
+    t->hits = INITIALIZE;
+}
+
+void transposition_new_search( transposition* t )
+{
+    t->generation = ( t->generation + 1 ) % TRANSPOSITION_GENERATIONS;
+}
+
+uint64_t transposition_key( game* g )
+{
+    // Storing the key of the stones
+    uint64_t key = g->board->key;
+
+    if ( g->type == GAME_RENJU ) {
+        key ^= TRANSPOSITION_RENJU_KEY;
+    }
+    if ( g->stone == WHITE_STONE ) {
+        key ^= TRANSPOSITION_WHITE_KEY;
+    }
+
+    // 0 marks an empty entry
+    return key ? key : 1;
+}
+
+bool transposition_probe( transposition* t, uint64_t key, transposition_entry* entry )
+{
+    // Storing the bucket the key goes to
+    transposition_bucket* bucket = &t->buckets[key & t->mask];
+
+    t->probes++;
+
+    for ( int i = INITIALIZE; i < TRANSPOSITION_BUCKET_ENTRIES; i++ ) {
+        if ( bucket->entries[i].key == key ) {
+            *entry = bucket->entries[i];
+            t->hits++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void transposition_store( transposition* t, uint64_t key, unsigned char depth, unsigned char bound, int score, unsigned char x, unsigned char y )
+{
+    // Storing the bucket the key goes to and the entry chosen in it
+    transposition_bucket* bucket = &t->buckets[key & t->mask];
+    transposition_entry* victim = NULL;
+
+    // Storing the worth of the victim, lower is replaced first
+    int worth = INITIALIZE;
+
+    for ( int i = INITIALIZE; i < TRANSPOSITION_BUCKET_ENTRIES; i++ ) {
+
+        transposition_entry* entry = &bucket->entries[i];
+
+        if ( entry->key == key ) {
+
+            // Storing whether the entry is from this search
+            bool current = entry->info >> TRANSPOSITION_GENERATION_SHIFT == t->generation;
+
+            if ( current && entry->depth > depth && bound != TRANSPOSITION_EXACT ) {
+                return;
+            }
+            if ( x >= BOARD_MAX_SIZE ) {
+                x = entry->x;
+                y = entry->y;
+            }
+            victim = entry;
+            break;
+        }
+
+        // Storing how many generations ago the entry was stored
+        int age = ( t->generation - ( entry->info >> TRANSPOSITION_GENERATION_SHIFT ) + TRANSPOSITION_GENERATIONS ) % TRANSPOSITION_GENERATIONS;
+        int value = entry->key == INITIALIZE ? -TRANSPOSITION_AGE_WEIGHT * TRANSPOSITION_GENERATIONS : entry->depth - TRANSPOSITION_AGE_WEIGHT * age;
+
+        if ( !victim || value < worth ) {
+            victim = entry;
+            worth = value;
+        }
+    }
+
+    victim->key = key;
+    victim->score = score;
+    victim->x = x;
+    victim->y = y;
+    victim->depth = depth;
+    victim->info = bound | t->generation << TRANSPOSITION_GENERATION_SHIFT;
+}
+
+transposition* transposition_local( void )
+{
+    pthread_once( &transposition_local_once, transposition_local_init );
+
+    // Storing the table of the calling thread, created the first time it asks
+    transposition* table = ( transposition* ) pthread_getspecific( transposition_local_key );
+
+    if ( !table ) {
+        table = transposition_create( TRANSPOSITION_DEFAULT_MB );
+        if ( table && pthread_setspecific( transposition_local_key, table ) != 0 ) {
+            transposition_delete( table );
+            table = NULL;
+        }
+    }
+
+    return table;
+}
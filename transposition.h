@@ -0,0 +1,126 @@
+#ifndef _TRANSPOSITION_H_
+#define _TRANSPOSITION_H_
+#include "game.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define TRANSPOSITION_DEFAULT_MB 16
+#define TRANSPOSITION_CACHE_LINE 64
+#define TRANSPOSITION_BUCKET_ENTRIES 4
+#define TRANSPOSITION_EXACT 1
+#define TRANSPOSITION_LOWER 2
+#define TRANSPOSITION_UPPER 3
+#define TRANSPOSITION_BOUND_MASK 0x03
+#define TRANSPOSITION_GENERATION_SHIFT 2
+#define TRANSPOSITION_GENERATIONS 64
+#define TRANSPOSITION_AGE_WEIGHT 8
+#define TRANSPOSITION_RENJU_KEY 0xD6E8FEB86659FD93ULL
+#define TRANSPOSITION_WHITE_KEY 0xA0761D6478BD642FULL
+
+/**
+ * One cached position, 16 bytes. key is the full 64-bit key, 0 for an empty entry. score is in whatever convention the search
+ * that stored it uses, depth is how deep the position was searched, and x, y is the best move found, BOARD_MAX_SIZE for none.
+ * info packs the bound (TRANSPOSITION_EXACT, TRANSPOSITION_LOWER or TRANSPOSITION_UPPER) in its low bits and
+ * the generation of the search that stored it above TRANSPOSITION_GENERATION_SHIFT.
+ */
+typedef struct {
+    uint64_t key;
+    int32_t score;
+    unsigned char x;
+    unsigned char y;
+    unsigned char depth;
+    unsigned char info;
+} transposition_entry;
+
+/**
+ * The entries a key can go to, exactly one cache line.
+ */
+typedef struct {
+    transposition_entry entries[TRANSPOSITION_BUCKET_ENTRIES];
+} transposition_bucket;
+
+/**
+ * A fixed-size transposition table: a power-of-two number of cache-line-aligned buckets, picked by the low bits of the key.
+ * generation is bumped by transposition_new_search() so entries from earlier searches are replaced first.
+ * probes and hits count the lookups and how many of them found the key.
+ * A table isn't locked; it must be used by one search at a time.
+ */
+typedef struct {
+    transposition_bucket* buckets;
+    size_t mask;
+    unsigned char generation;
+    unsigned long probes;
+    unsigned long hits;
+} transposition;
+
+/**
+ * This function creates an empty table of at most megabytes megabytes, rounded down to a power of two number of buckets
+ * but never less than one bucket.
+ * If memory runs out, return NULL instead.
+ * @param megabytes The size of the table in megabytes.
+ * @return transposition* A pointer to the newly created table, or NULL.
+ */
+transposition* transposition_create(size_t megabytes);
+
+/**
+ * This function frees a table and its buckets.
+ * If t is NULL, return NULL_POINTER_ERR as defined in error-codes.h, otherwise return SUCCESS.
+ * @param t A pointer to the table.
+ * @return unsigned char SUCCESS, or NULL_POINTER_ERR.
+ */
+unsigned char transposition_delete(transposition* t);
+
+/**
+ * This function empties a table and resets its generation and counters.
+ * @param t A pointer to the table.
+ */
+void transposition_clear(transposition* t);
+
+/**
+ * This function starts a new generation in the table, to be called at the start of every search.
+ * Entries of older generations are kept and still found, but are the first to be replaced.
+ * @param t A pointer to the table.
+ */
+void transposition_new_search(transposition* t);
+
+/**
+ * This function returns the key of the position of game g for the table: the Zobrist key of the board,
+ * mixed with the game type and the side to move, so the same stones under different rules or turns don't collide.
+ * @param g A pointer to the game struct.
+ * @return uint64_t The key.
+ */
+uint64_t transposition_key(game* g);
+
+/**
+ * This function looks key up in the table and copies the entry to entry if it is there.
+ * @param t A pointer to the table.
+ * @param key The key of the position.
+ * @param entry A pointer to store the entry.
+ * @return bool true if the key was found, false otherwise.
+ */
+bool transposition_probe(transposition* t, uint64_t key, transposition_entry* entry);
+
+/**
+ * This function stores a search result for key. An entry of the same key is updated unless it holds a deeper result
+ * of the current generation that isn't being replaced by an exact one; its best move is kept if the new result has none.
+ * Otherwise the entry of the bucket worth least is replaced: an empty one, else the one with the lowest depth,
+ * where every generation of age costs TRANSPOSITION_AGE_WEIGHT plies.
+ * @param t A pointer to the table.
+ * @param key The key of the position.
+ * @param depth The depth of the search.
+ * @param bound TRANSPOSITION_EXACT, TRANSPOSITION_LOWER or TRANSPOSITION_UPPER.
+ * @param score The score.
+ * @param x The horizontal coordinate of the best move, BOARD_MAX_SIZE for none.
+ * @param y The vertical coordinate of the best move.
+ */
+void transposition_store(transposition* t, uint64_t key, unsigned char depth, unsigned char bound, int score, unsigned char x, unsigned char y);
+
+/**
+ * This function returns the table of the calling thread, used by its searches that aren't given one of their own,
+ * TRANSPOSITION_DEFAULT_MB megabytes, created the first time the thread asks for it and freed when the thread exits.
+ * Games searched on different threads never share it, and a thread runs one search at a time.
+ * @return transposition* A pointer to the thread's table, or NULL if it couldn't be created.
+ */
+transposition* transposition_local(void);
+#endif
@@ -0,0 +1,519 @@
+/**
+* @file vcf.c
+* @author Sadia Ahmed (sahmed23)
+* This file searches for a victory by continuous fours,
+* a win made only of fours the opponent must block one by one
+*/
+
+#include "vcf.h"
+#include "game.h"
+#include "board.h"
+#include "pattern.h"
+#include "transposition.h"
+#include "rules.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Steps along each direction, indexed by the DIRECTION_* constants
+static const int direction_dx[BOARD_DIRECTIONS] = { 1, 0, 1, 1 };
+static const int direction_dy[BOARD_DIRECTIONS] = { 0, 1, 1, -1 };
+
+// How far along a line the stones of a five can be from one of its points
+#define VCF_REACH ( WIN_CONDITION - 1 )
+
+// The pattern classes of a four, as a bitmask indexed by class
+#define VCF_FOUR_TYPES ( 1 << PATTERN_FOUR | 1 << PATTERN_STRAIGHT_FOUR | 1 << PATTERN_DOUBLE_FOUR )
+#define VCF_FIVE_TYPES ( 1 << PATTERN_FIVE )
+#define VCF_THREE_TYPES ( 1 << PATTERN_THREE )
+#define VCF_STRAIGHT_FOUR_TYPES ( 1 << PATTERN_STRAIGHT_FOUR | 1 << PATTERN_DOUBLE_FOUR )
+
+// The most five points a single stone can leave, two on each line
+#define VCF_MAX_FIVE_POINTS ( 2 * BOARD_DIRECTIONS )
+
+/**
+ * The bookkeeping of one search. sequence holds the moves of the line being searched.
+ */
+typedef struct {
+    const vcf_limits* limits;
+    unsigned long nodes;
+    bool stopped;
+    move sequence[VCF_MAX_SEQUENCE];
+} vcf_context;
+
+/**
+ * This function returns the pattern rule that applies to stone in game g.
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @return unsigned char PATTERN_EXACT_FIVE for black in Renju, PATTERN_FIVE_OR_MORE otherwise.
+ */
+static unsigned char vcf_rule( game* g, unsigned char stone )
+{
+    return g->type == GAME_RENJU && stone == BLACK_STONE ? PATTERN_EXACT_FIVE : PATTERN_FIVE_OR_MORE;
+}
+
+/**
+ * This function finds the intersection at bit index of line k in the given direction: row k, column k,
+ * diagonal k (x - y + size - 1) or anti-diagonal k (x + y), with bits numbered as by board_line().
+ * @param size The size of the board.
+ * @param direction The direction of the line.
+ * @param k The index of the line.
+ * @param index The bit index on the line.
+ * @param x A pointer to store the horizontal coordinate.
+ * @param y A pointer to store the vertical coordinate.
+ */
+static void vcf_line_point( int size, unsigned char direction, int k, int index, unsigned char* x, unsigned char* y )
+{
+    switch ( direction ) {
+        case DIRECTION_HORIZONTAL:
+            *x = index;
+            *y = k;
+            break;
+        case DIRECTION_VERTICAL:
+            *x = k;
+            *y = index;
+            break;
+        case DIRECTION_DIAGONAL:
+            *x = index;
+            *y = index - k + size - 1;
+            break;
+        default:
+            *x = index;
+            *y = k - index;
+            break;
+    }
+}
+
+/**
+ * This function returns true if at least count bits of bits are set, clearing the lowest set bit at most count times.
+ * @param bits The bitmask.
+ * @param count The number of bits wanted.
+ * @return bool true if bits has count set bits or more.
+ */
+static bool vcf_at_least( uint32_t bits, int count )
+{
+    for ( int i = 1; i < count && bits; i++ ) {
+        bits &= bits - 1;
+    }
+
+    return bits != INITIALIZE;
+}
+
+/**
+ * This function returns the bitmask of the stones of colour index color on line k in the given direction,
+ * read straight from the bitboards of board b, with bits numbered as by board_line().
+ * @param b A pointer to the board struct.
+ * @param color The stone type minus one.
+ * @param direction The direction of the line.
+ * @param k The index of the line.
+ * @return uint32_t The bitmask of the line.
+ */
+static uint32_t vcf_line( board* b, int color, unsigned char direction, int k )
+{
+    switch ( direction ) {
+        case DIRECTION_HORIZONTAL:
+            return b->rows[color][k];
+        case DIRECTION_VERTICAL:
+            return b->cols[color][k];
+        case DIRECTION_DIAGONAL:
+            return b->diagonals[color][k];
+        default:
+            return b->anti_diagonals[color][k];
+    }
+}
+
+/**
+ * This function stores in points the empty intersections where a stone of type stone makes a line of one of the pattern classes
+ * in types on some line. Lines with fewer than stones own stones are skipped whole, and on the others only points with
+ * at least stones own stones within VCF_REACH are classified with pattern_line().
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @param stones The fewest own stones a line needs near the point.
+ * @param types The wanted pattern classes, bit i standing for class i.
+ * @param points A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes.
+ * @return int The number of points.
+ */
+static int vcf_scan( game* g, unsigned char stone, int stones, int types, unsigned char* points )
+{
+    // Storing the size of the board, the rule of the player and the opponent's stone type
+    int size = g->board->size;
+    unsigned char rule = vcf_rule( g, stone );
+    unsigned char other = stone == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    // Storing the points already found, one bitmask per row, and how many there are
+    uint32_t found[BOARD_MAX_SIZE] = { INITIALIZE };
+    int count = INITIALIZE;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+        // Storing the number of lines in the direction
+        int lines = direction < DIRECTION_DIAGONAL ? size : 2 * size - 1;
+
+        for ( int k = INITIALIZE; k < lines; k++ ) {
+
+            // Storing the first and last bit of the line, only diagonals are shorter than the board
+            int first = direction < DIRECTION_DIAGONAL || k < size ? INITIALIZE : k - size + 1;
+            int last = direction < DIRECTION_DIAGONAL || k >= size ? size - 1 : k;
+
+            // Storing the own stones of the line
+            uint32_t own = vcf_line( g->board, stone - 1, direction, k );
+
+            if ( !vcf_at_least( own, stones ) ) {
+                continue;
+            }
+
+            // Storing the empty intersections of the line within VCF_REACH of an own stone
+            uint32_t near = INITIALIZE;
+
+            for ( int i = -VCF_REACH; i <= VCF_REACH; i++ ) {
+                near |= i < INITIALIZE ? own >> -i : own << i;
+            }
+            near &= ( ( ( uint32_t ) 2 << last ) - ( ( uint32_t ) 1 << first ) ) & ~( own | vcf_line( g->board, other - 1, direction, k ) );
+
+            while ( near ) {
+
+                // Storing the bit of the lowest point and the own stones up to VCF_REACH away from it
+                int index = __builtin_ctz( near );
+                uint32_t window = ( uint32_t ) ( ( ( uint64_t ) own << VCF_REACH ) >> index ) & ( ( 1 << ( 2 * VCF_REACH + 1 ) ) - 1 );
+
+                // Storing the intersection of the point
+                unsigned char x;
+                unsigned char y;
+
+                near &= near - 1;
+                vcf_line_point( size, direction, k, index, &x, &y );
+
+                if ( vcf_at_least( window, stones ) && !( found[y] >> x & 1 ) &&
+                     types >> pattern_type( pattern_line( g->board, x, y, direction, stone, rule ) ) & 1 ) {
+                    found[y] |= ( uint32_t ) 1 << x;
+                    points[2 * count] = x;
+                    points[2 * count + 1] = y;
+                    count++;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+
+void vcf_default_limits( vcf_limits* limits )
+{
+    limits->max_depth = VCF_DEFAULT_DEPTH;
+    limits->max_nodes = VCF_DEFAULT_NODES;
+    limits->table = transposition_local( );
+}
+
+
+int vcf_fives( game* g, unsigned char stone, unsigned char* points )
+{
+    return vcf_scan( g, stone, WIN_CONDITION - 1, VCF_FIVE_TYPES, points );
+}
+
+
+int vcf_fours( game* g, unsigned char stone, unsigned char* points )
+{
+    return vcf_scan( g, stone, WIN_CONDITION - 2, VCF_FOUR_TYPES, points );
+}
+
+
+int vcf_threes( game* g, unsigned char stone, unsigned char* points )
+{
+    return vcf_scan( g, stone, WIN_CONDITION - 3, VCF_THREE_TYPES, points );
+}
+
+
+int vcf_straight_fours( game* g, unsigned char stone, unsigned char* points )
+{
+    // Storing the points found, before the forbidden ones are dropped
+    int count = vcf_scan( g, stone, WIN_CONDITION - 2, VCF_STRAIGHT_FOUR_TYPES, points );
+
+    if ( vcf_rule( g, stone ) == PATTERN_FIVE_OR_MORE ) {
+        return count;
+    }
+
+    // Storing the number of points kept
+    int kept = INITIALIZE;
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        if ( !rules_is_forbidden( g->board, points[2 * i], points[2 * i + 1] ) ) {
+            points[2 * kept] = points[2 * i];
+            points[2 * kept + 1] = points[2 * i + 1];
+            kept++;
+        }
+    }
+
+    return kept;
+}
+
+
+int vcf_five_points( game* g, unsigned char x, unsigned char y, unsigned char* points )
+{
+    // Storing the stone at x, y and its rule
+    unsigned char stone = board_get( g->board, x, y );
+    unsigned char rule = vcf_rule( g, stone );
+
+    // Storing the number of points found
+    int count = INITIALIZE;
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+        // Storing the pattern of the line
+        uint16_t entry = pattern_line( g->board, x, y, direction, stone, rule );
+
+        if ( !( VCF_FOUR_TYPES >> pattern_type( entry ) & 1 ) ) {
+            continue;
+        }
+
+        for ( uint16_t bits = pattern_points( entry ); bits; bits &= bits - 1 ) {
+
+            // Storing the point of the lowest bit
+            int offset = __builtin_ctz( bits ) - PATTERN_CENTER;
+            unsigned char px = x + offset * direction_dx[direction];
+            unsigned char py = y + offset * direction_dy[direction];
+
+            // Storing whether the point was already found on another line
+            bool repeated = false;
+
+            for ( int i = INITIALIZE; i < count; i++ ) {
+                repeated = repeated || ( points[2 * i] == px && points[2 * i + 1] == py );
+            }
+            if ( !repeated ) {
+                points[2 * count] = px;
+                points[2 * count + 1] = py;
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * This function stores the move at x, y for stone at ply ply of the line being searched.
+ * @param context A pointer to the search bookkeeping.
+ * @param ply The index of the move in the line.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param stone The stone type.
+ */
+static void vcf_record( vcf_context* context, int ply, unsigned char x, unsigned char y, unsigned char stone )
+{
+    context->sequence[ply].x = x;
+    context->sequence[ply].y = y;
+    context->sequence[ply].stone = stone;
+    context->sequence[ply].state = GAME_STATE_PLAYING;
+    context->sequence[ply].winner = EMPTY_INTERSECTION;
+}
+
+/**
+ * This function tries the four at x, y for the side to move in game g: the defender's block is played,
+ * and the search goes on from there. g is left as it was found.
+ * @param context A pointer to the search bookkeeping.
+ * @param g A pointer to the game struct.
+ * @param x The horizontal coordinate of the four.
+ * @param y The vertical coordinate of the four.
+ * @param depth The number of fours left, this one included.
+ * @param ply The index of the four in the line.
+ * @return int The length of the winning line from ply on, or 0 if the four doesn't win.
+ */
+static int vcf_try( vcf_context* context, game* g, unsigned char x, unsigned char y, int depth, int ply );
+
+/**
+ * This function searches the position of game g for a VCF of at most depth fours by the side to move.
+ * @param context A pointer to the search bookkeeping.
+ * @param g A pointer to the game struct.
+ * @param depth The number of fours left.
+ * @param ply The index in the line of the next move.
+ * @return int The length of the winning line from ply on, or 0 if there is none.
+ */
+static int vcf_node( vcf_context* context, game* g, int depth, int ply )
+{
+    // Storing the attacker and the defender
+    unsigned char attacker = g->stone;
+    unsigned char defender = attacker == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    // Storing the points found by the scans
+    unsigned char points[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+
+    context->nodes++;
+
+    // A five point of the attacker wins on the spot
+    if ( vcf_fives( g, attacker, points ) > INITIALIZE ) {
+        vcf_record( context, ply, points[INITIALIZE], points[1], attacker );
+        return 1;
+    }
+
+    if ( depth <= INITIALIZE ) {
+        return INITIALIZE;
+    }
+
+    if ( context->limits->max_nodes && context->nodes >= context->limits->max_nodes ) {
+        context->stopped = true;
+        return INITIALIZE;
+    }
+
+    // Storing the five points of the defender, which the attacker's four must also block
+    unsigned char blocks[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int blocks_count = vcf_fives( g, defender, blocks );
+
+    if ( blocks_count > 1 ) {
+        return INITIALIZE;
+    }
+
+    // Storing the cached result of the position, if any
+    transposition* table = context->limits->table;
+    uint64_t key = table ? transposition_key( g ) ^ VCF_KEY : INITIALIZE;
+    transposition_entry entry = { INITIALIZE, INITIALIZE, BOARD_MAX_SIZE, BOARD_MAX_SIZE, INITIALIZE, INITIALIZE };
+
+    if ( table && transposition_probe( table, key, &entry ) &&
+         ( entry.info & TRANSPOSITION_BOUND_MASK ) == TRANSPOSITION_UPPER && entry.depth >= depth ) {
+        return INITIALIZE;
+    }
+
+    // Storing the fours to try, the winning one of an earlier search first
+    int count = INITIALIZE;
+
+    if ( blocks_count == 1 ) {
+        points[INITIALIZE] = blocks[INITIALIZE];
+        points[1] = blocks[1];
+        count = 1;
+    } else {
+        count = vcf_fours( g, attacker, points );
+        for ( int i = 1; i < count; i++ ) {
+            if ( points[2 * i] == entry.x && points[2 * i + 1] == entry.y ) {
+                points[2 * i] = points[INITIALIZE];
+                points[2 * i + 1] = points[1];
+                points[INITIALIZE] = entry.x;
+                points[1] = entry.y;
+                break;
+            }
+        }
+    }
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+
+        // Storing the length of the line won by this four
+        int length = vcf_try( context, g, points[2 * i], points[2 * i + 1], depth, ply );
+
+        if ( length > INITIALIZE ) {
+            if ( table ) {
+                transposition_store( table, key, depth, TRANSPOSITION_EXACT, length, points[2 * i], points[2 * i + 1] );
+            }
+            return length;
+        }
+        if ( context->stopped ) {
+            return INITIALIZE;
+        }
+    }
+
+    if ( table ) {
+        transposition_store( table, key, depth, TRANSPOSITION_UPPER, INITIALIZE, BOARD_MAX_SIZE, BOARD_MAX_SIZE );
+    }
+
+    return INITIALIZE;
+}
+
+static int vcf_try( vcf_context* context, game* g, unsigned char x, unsigned char y, int depth, int ply )
+{
+    // Storing the attacker
+    unsigned char attacker = g->stone;
+
+    // A move that can't be stored stops the search, nothing was placed to take back
+    if ( !game_place_stone( g, x, y ) ) {
+        context->stopped = true;
+        return INITIALIZE;
+    }
+
+    // A forbidden four of black in Renju loses rather than threatens
+    if ( g->state != GAME_STATE_PLAYING ) {
+        game_unplace_stone( g );
+        return INITIALIZE;
+    }
+
+    // Storing the points that now make five for the attacker
+    unsigned char fives[2 * VCF_MAX_FIVE_POINTS];
+    int fives_count = vcf_five_points( g, x, y, fives );
+
+    // Storing the length of the line won, 0 for none
+    int length = INITIALIZE;
+
+    if ( fives_count > INITIALIZE ) {
+
+        vcf_record( context, ply, x, y, attacker );
+
+        if ( !game_place_stone( g, fives[INITIALIZE], fives[1] ) ) {
+            context->stopped = true;
+            game_unplace_stone( g );
+            return INITIALIZE;
+        }
+        vcf_record( context, ply + 1, fives[INITIALIZE], fives[1], g->moves[g->moves_count - 1].stone );
+
+        if ( g->state == GAME_STATE_FORBIDDEN ) {
+
+            // The only block is forbidden for black
+            length = 2;
+        } else if ( fives_count > 1 ) {
+
+            // Two points to make five can't both be blocked
+            vcf_record( context, ply + 2, fives[2], fives[3], attacker );
+            length = 3;
+        } else if ( g->state == GAME_STATE_PLAYING ) {
+
+            // Storing the length of the line that follows the block
+            int rest = vcf_node( context, g, depth - 1, ply + 2 );
+
+            length = rest > INITIALIZE ? rest + 2 : INITIALIZE;
+        }
+        game_unplace_stone( g );
+    }
+
+    game_unplace_stone( g );
+
+    return length;
+}
+
+
+bool vcf_search( game* g, const vcf_limits* limits, vcf_result* result )
+{
+    // Storing the bookkeeping of the search
+    vcf_context context;
+
+    context.limits = limits;
+    context.nodes = INITIALIZE;
+    context.stopped = false;
+
+    result->found = false;
+    result->stopped = false;
+    result->length = INITIALIZE;
+    result->nodes = INITIALIZE;
+
+    if ( g->state != GAME_STATE_PLAYING ) {
+        return false;
+    }
+
+    // Storing the deepest number of fours allowed
+    int max_depth = limits->max_depth > INITIALIZE && limits->max_depth < VCF_MAX_DEPTH ? limits->max_depth : VCF_MAX_DEPTH;
+
+    // The search plays its moves on g itself, none of them belong in the journal
+    struct journal* journal = g->journal;
+
+    g->journal = NULL;
+
+    // Storing the length of the winning line
+    int length = vcf_node( &context, g, max_depth, INITIALIZE );
+
+    g->journal = journal;
+
+    for ( int i = INITIALIZE; i < length; i++ ) {
+        result->sequence[i] = context.sequence[i];
+    }
+
+    result->found = length > INITIALIZE;
+    result->stopped = context.stopped;
+    result->length = length;
+    result->nodes = context.nodes;
+
+    return result->found;
+}
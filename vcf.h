@@ -0,0 +1,108 @@
+#ifndef _VCF_H_
+#define _VCF_H_
+#include "game.h"
+#include "transposition.h"
+#include <stdbool.h>
+
+#define VCF_MAX_DEPTH 32
+#define VCF_DEFAULT_DEPTH 16
+#define VCF_DEFAULT_NODES 5000
+#define VCF_MAX_SEQUENCE ( 2 * VCF_MAX_DEPTH + 1 )
+#define VCF_KEY 0x8EBC6AF09C88C6E3ULL
+
+/**
+ * The budget of a VCF search: at most max_depth fours by the attacker (capped at VCF_MAX_DEPTH) and max_nodes nodes, 0 for no limit.
+ * table is the transposition table used to remember positions without a VCF, or NULL.
+ */
+typedef struct {
+    unsigned char max_depth;
+    unsigned long max_nodes;
+    transposition* table;
+} vcf_limits;
+
+/**
+ * The outcome of a VCF search. If found is true, sequence holds length moves, attacker and defender alternating,
+ * starting with the attacker's first four and ending with the attacker's five or the defender's forbidden block.
+ * stopped is true if the node budget ran out or a move couldn't be stored for lack of memory, in which case not finding a VCF proves nothing.
+ */
+typedef struct {
+    bool found;
+    bool stopped;
+    unsigned char length;
+    move sequence[VCF_MAX_SEQUENCE];
+    unsigned long nodes;
+} vcf_result;
+
+/**
+ * This function fills limits with the default budget, VCF_DEFAULT_DEPTH fours and VCF_DEFAULT_NODES nodes,
+ * using the calling thread's table from transposition_local().
+ * @param limits A pointer to the limits struct to fill.
+ */
+void vcf_default_limits(vcf_limits* limits);
+
+/**
+ * This function stores in points the empty intersections where a stone of type stone would make five in game g,
+ * exactly five for black in Renju, as x, y pairs.
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @param points A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes.
+ * @return int The number of points.
+ */
+int vcf_fives(game* g, unsigned char stone, unsigned char* points);
+
+/**
+ * This function stores in points the empty intersections where a stone of type stone would make a four in game g
+ * (a line with exactly one point left to complete a five, or two), as x, y pairs. Forbidden points for black in Renju are included;
+ * playing them with game_place_stone() tells them apart.
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @param points A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes.
+ * @return int The number of points.
+ */
+int vcf_fours(game* g, unsigned char stone, unsigned char* points);
+
+/**
+ * This function stores in points the empty intersections where a stone of type stone would make a three in game g,
+ * a line one move away from a straight four, as x, y pairs. Forbidden points for black in Renju are included.
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @param points A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes.
+ * @return int The number of points.
+ */
+int vcf_threes(game* g, unsigned char stone, unsigned char* points);
+
+/**
+ * This function stores in points the empty intersections where a stone of type stone would leave two points to make five
+ * on one line in game g (a straight four, or two fours on the line), as x, y pairs. Forbidden points for black in Renju are left out,
+ * so every point found wins unless the opponent already has a five point.
+ * @param g A pointer to the game struct.
+ * @param stone The stone type.
+ * @param points A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes.
+ * @return int The number of points.
+ */
+int vcf_straight_fours(game* g, unsigned char stone, unsigned char* points);
+
+/**
+ * This function stores in points the empty intersections that complete a five for the stone at x, y in game g,
+ * on the lines through x, y, as x, y pairs, without repeats.
+ * @param g A pointer to the game struct.
+ * @param x The horizontal coordinate of a stone.
+ * @param y The vertical coordinate of the stone.
+ * @param points A buffer of 2 * BOARD_DIRECTIONS * 2 bytes.
+ * @return int The number of points.
+ */
+int vcf_five_points(game* g, unsigned char x, unsigned char y, unsigned char* points);
+
+/**
+ * This function looks for a victory by continuous fours for the side to move in game g: a sequence of fours, each forcing the
+ * one block that stops it, ending in a five or in a block that is a forbidden move for black in Renju.
+ * Moves are played with game_place_stone() and taken back with game_unplace_stone(), so five, overline and the Renju bans
+ * are judged exactly as in a game. An attacker facing a four of the defender may only play a four that also blocks it.
+ * g is left as it was found.
+ * @param g A pointer to the game struct, whose state must be GAME_STATE_PLAYING.
+ * @param limits A pointer to the search budget.
+ * @param result A pointer to store the outcome.
+ * @return bool true if a VCF was found.
+ */
+bool vcf_search(game* g, const vcf_limits* limits, vcf_result* result);
+#endif
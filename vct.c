@@ -0,0 +1,487 @@
+/**
+* @file vct.c
+* @author Sadia Ahmed (sahmed23)
+* This file searches for a victory by continuous threats,
+* a win made of fours and threes the opponent can't all answer
+*/
+
+#include "vct.h"
+#include "vcf.h"
+#include "game.h"
+#include "board.h"
+#include "pattern.h"
+#include "transposition.h"
+#include "rules.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Steps along each direction, indexed by the DIRECTION_* constants
+static const int direction_dx[BOARD_DIRECTIONS] = { 1, 0, 1, 1 };
+static const int direction_dy[BOARD_DIRECTIONS] = { 0, 1, 1, -1 };
+
+/**
+ * The bookkeeping of one search. sequence holds the moves of the line being searched.
+ */
+typedef struct {
+    const vct_limits* limits;
+    unsigned long nodes;
+    bool stopped;
+    move sequence[VCT_MAX_SEQUENCE];
+} vct_context;
+
+/**
+ * A reply of the defender to a three, and whether it is a four of the defender's own.
+ */
+typedef struct {
+    unsigned char x;
+    unsigned char y;
+    bool counter;
+} vct_defence;
+
+/**
+ * This function stores the move at x, y for stone at ply ply of the line being searched.
+ * @param context A pointer to the search bookkeeping.
+ * @param ply The index of the move in the line.
+ * @param x The horizontal coordinate.
+ * @param y The vertical coordinate.
+ * @param stone The stone type.
+ */
+static void vct_record( vct_context* context, int ply, unsigned char x, unsigned char y, unsigned char stone )
+{
+    context->sequence[ply].x = x;
+    context->sequence[ply].y = y;
+    context->sequence[ply].stone = stone;
+    context->sequence[ply].state = GAME_STATE_PLAYING;
+    context->sequence[ply].winner = EMPTY_INTERSECTION;
+}
+
+/**
+ * This function searches the position of game g, the defender to move, after a move of the attacker.
+ * @param context A pointer to the search bookkeeping.
+ * @param g A pointer to the game struct.
+ * @param depth The number of attacker moves left.
+ * @param ply The index in the line of the defender's move.
+ * @param length A pointer to store the length of the principal line from ply on.
+ * @return bool true if the attacker wins against every defence.
+ */
+static bool vct_and( vct_context* context, game* g, int depth, int ply, int* length );
+
+/**
+ * This function searches the position of game g, the attacker to move, for a VCT of at most depth attacker moves.
+ * @param context A pointer to the search bookkeeping.
+ * @param g A pointer to the game struct.
+ * @param depth The number of attacker moves left.
+ * @param ply The index in the line of the attacker's move.
+ * @param length A pointer to store the length of the principal line from ply on.
+ * @return bool true if the attacker wins.
+ */
+static bool vct_or( vct_context* context, game* g, int depth, int ply, int* length )
+{
+    // Storing the attacker and the defender
+    unsigned char attacker = g->stone;
+    unsigned char defender = attacker == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    // Storing the points found by the scans
+    unsigned char points[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+
+    context->nodes++;
+
+    // A five point of the attacker wins on the spot
+    if ( vcf_fives( g, attacker, points ) > INITIALIZE ) {
+        vct_record( context, ply, points[INITIALIZE], points[1], attacker );
+        *length = 1;
+        return true;
+    }
+
+    if ( depth <= INITIALIZE ) {
+        return false;
+    }
+
+    if ( context->limits->max_nodes && context->nodes >= context->limits->max_nodes ) {
+        context->stopped = true;
+        return false;
+    }
+
+    // Storing the number of five points of the defender, which the attacker must block first
+    int count = vcf_fives( g, defender, points );
+
+    if ( count > 1 ) {
+        return false;
+    }
+
+    // Storing the cached result of the position, if any
+    transposition* table = context->limits->table;
+    uint64_t key = table ? transposition_key( g ) ^ VCT_KEY : INITIALIZE;
+    transposition_entry entry = { INITIALIZE, INITIALIZE, BOARD_MAX_SIZE, BOARD_MAX_SIZE, INITIALIZE, INITIALIZE };
+
+    if ( table && transposition_probe( table, key, &entry ) &&
+         ( entry.info & TRANSPOSITION_BOUND_MASK ) == TRANSPOSITION_UPPER && entry.depth >= depth ) {
+        return false;
+    }
+
+    // The moves are the block if there is one, otherwise the fours and then the threes not already among them
+    if ( count == INITIALIZE ) {
+
+        // Storing the fours, one bitmask per row
+        uint32_t fours[BOARD_MAX_SIZE] = { INITIALIZE };
+
+        count = vcf_fours( g, attacker, points );
+        for ( int i = INITIALIZE; i < count; i++ ) {
+            fours[points[2 * i + 1]] |= ( uint32_t ) 1 << points[2 * i];
+        }
+
+        // Storing the threes
+        unsigned char threes[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+        int threes_count = vcf_threes( g, attacker, threes );
+
+        for ( int i = INITIALIZE; i < threes_count; i++ ) {
+            if ( !( fours[threes[2 * i + 1]] >> threes[2 * i] & 1 ) ) {
+                points[2 * count] = threes[2 * i];
+                points[2 * count + 1] = threes[2 * i + 1];
+                count++;
+            }
+        }
+    }
+
+    // The winning move of an earlier search is tried first
+    for ( int i = 1; i < count; i++ ) {
+        if ( points[2 * i] == entry.x && points[2 * i + 1] == entry.y ) {
+            points[2 * i] = points[INITIALIZE];
+            points[2 * i + 1] = points[1];
+            points[INITIALIZE] = entry.x;
+            points[1] = entry.y;
+            break;
+        }
+    }
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+
+        // A move that can't be stored stops the search, nothing was placed to take back
+        if ( !game_place_stone( g, points[2 * i], points[2 * i + 1] ) ) {
+            context->stopped = true;
+            return false;
+        }
+
+        // A forbidden move of black in Renju loses rather than threatens
+        if ( g->state != GAME_STATE_PLAYING ) {
+            game_unplace_stone( g );
+            continue;
+        }
+
+        // Storing the length of the line that follows the move
+        int rest = INITIALIZE;
+
+        vct_record( context, ply, points[2 * i], points[2 * i + 1], attacker );
+        bool won = vct_and( context, g, depth - 1, ply + 1, &rest );
+        game_unplace_stone( g );
+
+        if ( won ) {
+            if ( table ) {
+                transposition_store( table, key, depth, TRANSPOSITION_EXACT, rest + 1, points[2 * i], points[2 * i + 1] );
+            }
+            *length = rest + 1;
+            return true;
+        }
+        if ( context->stopped ) {
+            return false;
+        }
+    }
+
+    if ( table ) {
+        transposition_store( table, key, depth, TRANSPOSITION_UPPER, INITIALIZE, BOARD_MAX_SIZE, BOARD_MAX_SIZE );
+    }
+
+    return false;
+}
+
+/**
+ * This function lists the replies of the defender to a three: every four of the defender,
+ * and every empty intersection up to PATTERN_CENTER away on the lines where the point x, y makes a straight four for the attacker.
+ * @param g A pointer to the game struct, the defender to move.
+ * @param x The horizontal coordinate of a straight four point of the attacker.
+ * @param y The vertical coordinate of the straight four point.
+ * @param defences The buffer to store the replies, BOARD_MAX_SIZE * BOARD_MAX_SIZE entries.
+ * @return int The number of replies.
+ */
+static int vct_defences( game* g, unsigned char x, unsigned char y, vct_defence* defences )
+{
+    // Storing the attacker and its rule
+    unsigned char attacker = g->stone == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+    unsigned char rule = g->type == GAME_RENJU && attacker == BLACK_STONE ? PATTERN_EXACT_FIVE : PATTERN_FIVE_OR_MORE;
+
+    // Storing the replies already listed, one bitmask per row
+    uint32_t listed[BOARD_MAX_SIZE] = { INITIALIZE };
+
+    // Storing the fours of the defender
+    unsigned char points[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int count = vcf_fours( g, g->stone, points );
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+        defences[i].x = points[2 * i];
+        defences[i].y = points[2 * i + 1];
+        defences[i].counter = true;
+        listed[points[2 * i + 1]] |= ( uint32_t ) 1 << points[2 * i];
+    }
+
+    for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+        // Storing the pattern the point makes on the line
+        int type = pattern_type( pattern_line( g->board, x, y, direction, attacker, rule ) );
+
+        if ( type != PATTERN_STRAIGHT_FOUR && type != PATTERN_DOUBLE_FOUR ) {
+            continue;
+        }
+
+        for ( int offset = -PATTERN_CENTER; offset <= PATTERN_CENTER; offset++ ) {
+
+            // Storing the intersection offset steps away
+            int px = x + offset * direction_dx[direction];
+            int py = y + offset * direction_dy[direction];
+
+            if ( px < INITIALIZE || py < INITIALIZE || px >= g->board->size || py >= g->board->size ||
+                 board_get( g->board, px, py ) != EMPTY_INTERSECTION || listed[py] >> px & 1 ) {
+                continue;
+            }
+
+            listed[py] |= ( uint32_t ) 1 << px;
+            defences[count].x = px;
+            defences[count].y = py;
+            defences[count].counter = false;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * This function returns true if one of the count points at points still makes a straight four for attacker in game g,
+ * and isn't forbidden for black in Renju. Checking only these points after a defender's move may keep a reply that loses,
+ * but never drops one that holds.
+ * @param g A pointer to the game struct.
+ * @param attacker The attacker's stone type.
+ * @param points The straight four points of the attacker before the defender's move, as x, y pairs.
+ * @param count The number of points.
+ * @return bool true if a straight four point is left.
+ */
+static bool vct_straight_four_left( game* g, unsigned char attacker, const unsigned char* points, int count )
+{
+    // Storing the rule of the attacker
+    unsigned char rule = g->type == GAME_RENJU && attacker == BLACK_STONE ? PATTERN_EXACT_FIVE : PATTERN_FIVE_OR_MORE;
+
+    for ( int i = INITIALIZE; i < count; i++ ) {
+
+        // Storing the point
+        unsigned char x = points[2 * i];
+        unsigned char y = points[2 * i + 1];
+
+        if ( board_get( g->board, x, y ) != EMPTY_INTERSECTION ) {
+            continue;
+        }
+
+        for ( unsigned char direction = INITIALIZE; direction < BOARD_DIRECTIONS; direction++ ) {
+
+            // Storing the pattern the point makes on the line
+            int type = pattern_type( pattern_line( g->board, x, y, direction, attacker, rule ) );
+
+            if ( ( type == PATTERN_STRAIGHT_FOUR || type == PATTERN_DOUBLE_FOUR ) &&
+                 ( rule == PATTERN_FIVE_OR_MORE || !rules_is_forbidden( g->board, x, y ) ) ) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int vct_replies( game* g, const unsigned char* threats, int threats_count, unsigned char* replies )
+{
+    // Storing the side with the threes
+    unsigned char attacker = g->stone == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    // Storing the moves worth trying
+    vct_defence defences[BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int defences_count = vct_defences( g, threats[INITIALIZE], threats[1], defences );
+
+    // Storing the number of replies kept
+    int count = INITIALIZE;
+
+    for ( int i = INITIALIZE; i < defences_count; i++ ) {
+
+        // A reply that can't be stored for lack of memory is kept, it can't be ruled out
+        if ( !game_place_stone( g, defences[i].x, defences[i].y ) ) {
+            replies[2 * count] = defences[i].x;
+            replies[2 * count + 1] = defences[i].y;
+            count++;
+            continue;
+        }
+
+        // A forbidden reply of black loses, and a reply that leaves a straight four loses to it
+        if ( g->state != GAME_STATE_FORBIDDEN &&
+             ( defences[i].counter || g->state != GAME_STATE_PLAYING || !vct_straight_four_left( g, attacker, threats, threats_count ) ) ) {
+            replies[2 * count] = defences[i].x;
+            replies[2 * count + 1] = defences[i].y;
+            count++;
+        }
+        game_unplace_stone( g );
+    }
+
+    return count;
+}
+
+static bool vct_and( vct_context* context, game* g, int depth, int ply, int* length )
+{
+    // Storing the defender and the attacker
+    unsigned char defender = g->stone;
+    unsigned char attacker = defender == BLACK_STONE ? WHITE_STONE : BLACK_STONE;
+
+    // Storing the points found by the scans
+    unsigned char points[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+
+    context->nodes++;
+
+    // A five point of the defender wins before the threat matters
+    if ( vcf_fives( g, defender, points ) > INITIALIZE ) {
+        return false;
+    }
+
+    // Storing the five points of the attacker, of which the defender must block one
+    int count = vcf_fives( g, attacker, points );
+
+    if ( count > INITIALIZE ) {
+
+        // Storing whether the block loses and the length of the line that follows it
+        bool won = false;
+        int rest = INITIALIZE;
+
+        if ( !game_place_stone( g, points[INITIALIZE], points[1] ) ) {
+            context->stopped = true;
+            return false;
+        }
+        vct_record( context, ply, points[INITIALIZE], points[1], defender );
+
+        if ( g->state == GAME_STATE_FORBIDDEN ) {
+
+            // The only block is forbidden for black
+            won = true;
+        } else if ( count > 1 ) {
+
+            // Two points to make five can't both be blocked
+            vct_record( context, ply + 1, points[2], points[3], attacker );
+            won = true;
+            rest = 1;
+        } else if ( g->state == GAME_STATE_PLAYING ) {
+            won = vct_or( context, g, depth, ply + 1, &rest );
+        }
+        game_unplace_stone( g );
+
+        *length = rest + 1;
+        return won;
+    }
+
+    // Without a four, the attacker's threat is a straight four to come
+    count = vcf_straight_fours( g, attacker, points );
+
+    if ( count == INITIALIZE ) {
+        return false;
+    }
+
+    // Storing the replies to the three
+    unsigned char replies[2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE];
+    int replies_count = vct_replies( g, points, count, replies );
+
+    // Storing the principal line so far, the reply that holds out longest
+    move best[VCT_MAX_SEQUENCE];
+    int best_length = INITIALIZE;
+
+    for ( int i = INITIALIZE; i < replies_count; i++ ) {
+
+        if ( !game_place_stone( g, replies[2 * i], replies[2 * i + 1] ) ) {
+            context->stopped = true;
+            return false;
+        }
+
+        // Storing whether the attacker still wins and the length of the line that follows the reply
+        bool won = false;
+        int rest = INITIALIZE;
+
+        vct_record( context, ply, replies[2 * i], replies[2 * i + 1], defender );
+        if ( g->state == GAME_STATE_PLAYING ) {
+            won = vct_or( context, g, depth, ply + 1, &rest );
+        }
+        game_unplace_stone( g );
+
+        if ( !won ) {
+            return false;
+        }
+
+        if ( rest + 1 > best_length ) {
+            best_length = rest + 1;
+            for ( int j = INITIALIZE; j < best_length; j++ ) {
+                best[j] = context->sequence[ply + j];
+            }
+        }
+    }
+
+    // With no reply left to try, the line ends with the attacker's threat
+    for ( int j = INITIALIZE; j < best_length; j++ ) {
+        context->sequence[ply + j] = best[j];
+    }
+    *length = best_length;
+
+    return true;
+}
+
+
+void vct_default_limits( vct_limits* limits )
+{
+    limits->max_depth = VCT_DEFAULT_DEPTH;
+    limits->max_nodes = VCT_DEFAULT_NODES;
+    limits->table = transposition_local( );
+}
+
+
+bool vct_search( game* g, const vct_limits* limits, vct_result* result )
+{
+    // Storing the bookkeeping of the search
+    vct_context context;
+
+    context.limits = limits;
+    context.nodes = INITIALIZE;
+    context.stopped = false;
+
+    result->found = false;
+    result->stopped = false;
+    result->length = INITIALIZE;
+    result->nodes = INITIALIZE;
+
+    if ( g->state != GAME_STATE_PLAYING ) {
+        return false;
+    }
+
+    // Storing the deepest number of attacker moves allowed
+    int max_depth = limits->max_depth > INITIALIZE && limits->max_depth < VCT_MAX_DEPTH ? limits->max_depth : VCT_MAX_DEPTH;
+
+    // The search plays its moves on g itself, none of them belong in the journal
+    struct journal* journal = g->journal;
+
+    g->journal = NULL;
+
+    // Storing the length of the principal line
+    int length = INITIALIZE;
+
+    result->found = vct_or( &context, g, max_depth, INITIALIZE, &length );
+
+    g->journal = journal;
+
+    for ( int i = INITIALIZE; result->found && i < length; i++ ) {
+        result->sequence[i] = context.sequence[i];
+    }
+
+    result->stopped = context.stopped;
+    result->length = result->found ? length : INITIALIZE;
+    result->nodes = context.nodes;
+
+    return result->found;
+}
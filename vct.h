@@ -0,0 +1,71 @@
+#ifndef _VCT_H_
+#define _VCT_H_
+#include "game.h"
+#include "transposition.h"
+#include <stdbool.h>
+
+#define VCT_MAX_DEPTH 16
+#define VCT_DEFAULT_DEPTH 5
+#define VCT_DEFAULT_NODES 10000
+#define VCT_MAX_SEQUENCE ( 2 * VCT_MAX_DEPTH + 1 )
+#define VCT_KEY 0x3C6EF372FE94F82BULL
+
+/**
+ * The budget of a VCT search: at most max_depth moves by the attacker before the five (capped at VCT_MAX_DEPTH)
+ * and max_nodes nodes, 0 for no limit. table is the transposition table used to remember proven and failed positions, or NULL.
+ */
+typedef struct {
+    unsigned char max_depth;
+    unsigned long max_nodes;
+    transposition* table;
+} vct_limits;
+
+/**
+ * The outcome of a VCT search. If found is true, sequence holds the principal line of the proof, length moves with attacker and
+ * defender alternating: the attacker's threats, and against each the defence that held out longest.
+ * The line ends with the attacker's five, the defender's forbidden block, or a threat with no defence left.
+ * stopped is true if the node budget ran out or a move couldn't be stored for lack of memory, in which case not finding a VCT proves nothing.
+ */
+typedef struct {
+    bool found;
+    bool stopped;
+    unsigned char length;
+    move sequence[VCT_MAX_SEQUENCE];
+    unsigned long nodes;
+} vct_result;
+
+/**
+ * This function fills limits with the default budget, VCT_DEFAULT_DEPTH moves and VCT_DEFAULT_NODES nodes,
+ * using the calling thread's table from transposition_local().
+ * @param limits A pointer to the limits struct to fill.
+ */
+void vct_default_limits(vct_limits* limits);
+
+/**
+ * This function lists the replies of the side to move in game g to the opponent's threes, given as the opponent's straight four points
+ * found by vcf_straight_fours(): the fours of the side to move, which the opponent must answer first, and the moves near the first
+ * straight four point that leave the opponent without one. Forbidden replies for black in Renju are left out.
+ * Any move not listed loses to a straight four, so none are listed if the threes can't all be stopped. A reply that can't be tried
+ * for lack of memory is listed, it can't be ruled out.
+ * @param g A pointer to the game struct.
+ * @param threats The opponent's straight four points, as x, y pairs, at least one.
+ * @param threats_count The number of straight four points.
+ * @param replies A buffer of 2 * BOARD_MAX_SIZE * BOARD_MAX_SIZE bytes to store the replies, as x, y pairs.
+ * @return int The number of replies.
+ */
+int vct_replies(game* g, const unsigned char* threats, int threats_count, unsigned char* replies);
+
+/**
+ * This function looks for a victory by continuous threats for the side to move in game g: a sequence of fours and threes
+ * that wins against every defence. A four is answered by its one block. A three is answered by every move that leaves the attacker
+ * without a straight four, and by every four of the defender, which the attacker must block before going on.
+ * Moves are played with game_place_stone() and taken back with game_unplace_stone(), so the Renju bans are judged as in a game:
+ * black's forbidden threats are never tried, a straight four of black on a forbidden point doesn't count, and a forbidden block
+ * or defence of black loses. g is left as it was found.
+ * @param g A pointer to the game struct, whose state must be GAME_STATE_PLAYING.
+ * @param limits A pointer to the search budget.
+ * @param result A pointer to store the outcome.
+ * @return bool true if a VCT was found.
+ */
+bool vct_search(game* g, const vct_limits* limits, vct_result* result);
+#endif